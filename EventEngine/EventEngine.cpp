@@ -1,4 +1,5 @@
 #include "../System/EventEngine/EventEngine.hpp"
+#include "../System/AllocationTripwire.hpp"
 
 void EventEngine::addListener(EventListener* _listener)
 {
@@ -18,11 +19,12 @@ void EventEngine::addListener(const std::string &_eventName, EventListener* _lis
 void EventEngine::dispatch(const std::string &_eventName, Event* _event)
 {
     // If some performance issue, we can think about sending the event in a new thread
-    if (m_specificListeners.count(_eventName) != 0) 
+    std::map<std::string, std::vector<EventListener*>>::iterator specificListeners = m_specificListeners.find(_eventName);
+    if (specificListeners != m_specificListeners.end()) 
 	{
-        for (unsigned int i = 0; i < m_specificListeners[_eventName].size(); i++) 
+        for (unsigned int i = 0; i < specificListeners->second.size(); i++) 
 		{
-            m_specificListeners[_eventName][i]->onEvent(_eventName, _event);
+            specificListeners->second[i]->onEvent(_eventName, _event);
         }
     }
 
@@ -30,3 +32,16 @@ void EventEngine::dispatch(const std::string &_eventName, Event* _event)
         m_generalsListeners[i]->onEvent(_eventName, _event);
     }
 }
+
+void EventEngine::dispatch(const char* _eventName, Event* _event)
+{
+    std::map<const char*, const std::string*, NameLess>::iterator name = m_nameIndex.find(_eventName);
+    if (name == m_nameIndex.end())
+    {
+        AllocationTripwire::ExpectedAllocations expectedAllocations; // Once per name, the first time it's dispatched
+        m_names.push_back(_eventName);
+        name = m_nameIndex.insert(std::make_pair(m_names.back().c_str(), &m_names.back())).first;
+    }
+
+    dispatch(*name->second, _event);
+}
@@ -0,0 +1,12 @@
+#include "../../System/Listener/RenderCommandsReadyListener.hpp"
+#include <iostream>
+
+RenderCommandsReadyListener::RenderCommandsReadyListener(GraphicsEngine* _graphicsEngine)
+{
+	m_graphicsEngine = _graphicsEngine;
+}
+
+void RenderCommandsReadyListener::onEvent(const std::string &_eventType, Event* _event)
+{
+	m_graphicsEngine->SetRenderCommands(_event->GetRenderCommands());
+}
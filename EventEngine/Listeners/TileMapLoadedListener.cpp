@@ -0,0 +1,12 @@
+#include "../../System/Listener/TileMapLoadedListener.hpp"
+#include <iostream>
+
+TileMapLoadedListener::TileMapLoadedListener(GraphicsEngine* _graphicsEngine)
+{
+	m_graphicsEngine = _graphicsEngine;
+}
+
+void TileMapLoadedListener::onEvent(const std::string &_eventType, Event* _event)
+{
+	m_graphicsEngine->SetTileMap(_event->GetTileMap());
+}
@@ -10,7 +10,7 @@ CollisionHandler::CollisionHandler(GameEngine *_parent, EventEngine *_eventEngin
 
 CollisionHandler::~CollisionHandler()
 {
-	delete m_gameEngine;
+
 }
 
 void CollisionHandler::HandleCollisionsWithMapEdges(MovingObject& _obj)
@@ -51,20 +51,37 @@ void CollisionHandler::ReactToCollisionsWithObj(MovingObject& _obj, DisplayableO
 	SendNewObjectPositionToGFX(_ref);
 }
 
+/* Only the tiles around the object are looked at. Tiles don't react to collisions: only the object is updated */
+void CollisionHandler::HandleCollisionsWithTiles(MovingObject& _obj, const TileMap& _tileMap)
+{
+	// One tile of margin: a reaction moves the object by less than that, and the tiles it can then hit have to be in the area too
+	sf::FloatRect area = _obj.GetCoordinates();
+	area.left -= TileMap::TileSize;
+	area.top -= TileMap::TileSize;
+	area.width += 2 * TileMap::TileSize;
+	area.height += 2 * TileMap::TileSize;
+
+	_tileMap.VisitTiles(area, [&](sf::Vector2f _position, unsigned short _typeIndex)
+	{
+		const TileType& type = _tileMap.GetType(_typeIndex);
+		sf::FloatRect tileRect(_position, type.size);
+		CollisionDirection direction = DetectCollisionWithRect(_obj.GetCoordinates(), tileRect);
+		if (direction == NO_COL)
+			return;
+
+		ReactToCollision(_obj, tileRect, direction);
+		_obj.UpdateAfterCollision(Util::OppositeCollisionDirection(direction), type.objectClass);
+		_obj.SetPosition(m_gameEngine->GetCoordinatesOfForegroundItem(_obj.GetID()));
+	});
+}
+
 /// Send information about the object that has been hit (for gfx to know about states changes)
 void CollisionHandler::SendNewObjectPositionToGFX(DisplayableObject& _obj)
 {
-	InfoForDisplay object_info = _obj.GetInfoForDisplay();
-	Event redisplayObject(&object_info);
-	if (_obj.GetClass() == PLAYER || _obj.GetClass() == ENEMY)
-	{
-		if (!((MovingObject&)_obj).IsDead())
-			m_eventEngine->dispatch("game.character_position_updated", &redisplayObject);
-	}
-	else
-	{
-		m_eventEngine->dispatch("game.foreground_item_updated", &redisplayObject);
-	}
+	if ((_obj.GetClass() == PLAYER || _obj.GetClass() == ENEMY) && ((MovingObject&)_obj).IsDead())
+		return;
+
+	m_gameEngine->SendToGFX(_obj);
 }
 
 CollisionDirection CollisionHandler::HandleCollisionWithRect(unsigned int _objId, sf::FloatRect _ref)
@@ -154,5 +171,5 @@ void CollisionHandler::ReactToCollision(DisplayableObject& _obj, sf::FloatRect _
 		default:
 			break;
 	}
-	m_gameEngine->UpdateForegroundItem(_obj.GetID(), objRect);
+	_obj.SetCoordinates(objRect);
 }
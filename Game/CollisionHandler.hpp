@@ -2,6 +2,7 @@
 #define COLLISION_HANDLER_H
 
 #include "../System/Characters/Player.hpp"
+#include "../System/TileMap.hpp"
 
 class GameEngine;
 class EventEngine;
@@ -19,6 +20,7 @@ class CollisionHandler
 
 		CollisionDirection DetectCollisionWithObj(MovingObject& _obj, DisplayableObject& _ref);
 		void ReactToCollisionsWithObj(MovingObject& _obj, DisplayableObject& _ref, CollisionDirection _direction);
+		void HandleCollisionsWithTiles(MovingObject& _obj, const TileMap& _tileMap);
 		void SendNewObjectPositionToGFX(DisplayableObject& _obj);
 		CollisionDirection HandleCollisionWithRect(unsigned int _objId, sf::FloatRect _ref);
 		CollisionDirection DetectCollisionWithRect(sf::FloatRect _obj, sf::FloatRect _ref);
@@ -1,20 +1,24 @@
 #include "GameEngine.hpp"
+#include "../System/AllocationTripwire.hpp"
+#include "../System/HitboxTable.hpp"
 #include "../System/Listener/CharacterDiedListener.hpp"
-#include "../System/Listener/ForegroundItemUpdatedListener.hpp"
 #include "../System/Listener/GotLevelInfoListener.hpp"
 #include "../System/Listener/KeyboardListener.hpp"
 #include "../System/Listener/NewCharacterReadListener.hpp"
-#include "../System/Listener/NewForegroundItemReadListener.hpp"
-#include "../System/Listener/NewPipeReadListener.hpp"
 #include "../System/Listener/ToggleIgnoreInputListener.hpp"
 #include "../Game/GameEvents.hpp"
 
-GameEngine::GameEngine(EventEngine *_eventEngine) : Engine(_eventEngine), m_levelStarted(false), m_indexMario(-1)
+GameEngine::GameEngine(EventEngine *_eventEngine) : Engine(_eventEngine), m_levelStreamer(NULL), m_indexLevel(0), m_streamLevels(false), m_useCompiledLevels(true), m_writeCompiledLevels(false), m_streamingFocus(0),
+	m_hotReload(false), m_indexMario(-1), m_levelStarted(false)
 {
+	HitboxTable::Load();
 	m_collisionHandler = new CollisionHandler(this, m_eventEngine);
-	m_levelImporter = new LevelImporter(_eventEngine);
+	m_levelImporter = new LevelImporter(_eventEngine, &m_levelArena, &m_tileMap);
 	CreateListeners();
 
+	// Read while gfx and s are created: the first frame doesn't wait for all of it
+	SetLevels(std::vector<std::string>(1, "activelvl")); // In the future there will be some sort of level selection
+
 #ifdef DEBUG_MODE
 	m_debugInfo = new DebugInfo();
 #endif
@@ -26,10 +30,6 @@ void GameEngine::CreateListeners()
 	m_eventEngine->addListener(CHARACTER_DIED, characterDiedListener);
 	m_createdListeners.push_back(characterDiedListener);
 
-	ForegroundItemUpdatedListener* foregroundItemUpdatedListener = new ForegroundItemUpdatedListener(this);
-	m_eventEngine->addListener(FOREGROUND_ITEM_UPDATED, foregroundItemUpdatedListener);
-	m_createdListeners.push_back(foregroundItemUpdatedListener);
-
 	GotLevelInfoListener* gotLevelInfoListener = new GotLevelInfoListener(this);
 	m_eventEngine->addListener(GOT_LVL_INFO, gotLevelInfoListener);
 	m_createdListeners.push_back(gotLevelInfoListener);
@@ -42,14 +42,6 @@ void GameEngine::CreateListeners()
 	m_eventEngine->addListener(NEW_CHARACTER_READ, newCharacterReadListener);
 	m_createdListeners.push_back(newCharacterReadListener);
 
-	NewForegroundItemReadListener* newForegroundItemReadListener = new NewForegroundItemReadListener(this);
-	m_eventEngine->addListener(NEW_FOREGROUND_ITEM_READ, newForegroundItemReadListener);
-	m_createdListeners.push_back(newForegroundItemReadListener);
-
-	NewPipeReadListener* newPipeReadListener = new NewPipeReadListener(this);
-	m_eventEngine->addListener(NEW_PIPE_READ, newPipeReadListener);
-	m_createdListeners.push_back(newPipeReadListener);
-
 	ToggleIgnoreInputListener* toggleIgnoreInputListener = new ToggleIgnoreInputListener(this);
 	m_eventEngine->addListener(TOGGLE_IGNORE_INPUT, toggleIgnoreInputListener);
 	m_createdListeners.push_back(toggleIgnoreInputListener);
@@ -57,14 +49,10 @@ void GameEngine::CreateListeners()
 
 GameEngine::~GameEngine()
 {
+	UnloadLevel();
 	delete m_collisionHandler;
 	delete m_levelImporter;
 
-	for (unsigned int i = 0; i < m_characters.size(); i++)
-		delete m_characters[i];
-	for (unsigned int i = 0; i < m_listForegroundItems.size(); i++)
-		delete m_listForegroundItems[i];
-
 	for (unsigned int i = 0; i < m_createdListeners.size(); i++)
 		delete m_createdListeners[i];
 
@@ -83,35 +71,60 @@ void GameEngine::Frame(float _dt)
 	MovingObject *currentCharacter = NULL;
 
 	if (!m_levelStarted)
-		StartLevel("activelvl"); // In the future there will be some sort of level selection so this call will be moved
-
-	// Spawn enemies from pipes
-	for (std::map<unsigned int, Pipe*>::iterator it = m_listPipes.begin(); it != m_listPipes.end(); ++it)
+		StartLevel(m_levelNames[m_indexLevel]);
+	else if (IsLevelCompleted())
+		StartLevel(m_levelNames[(m_indexLevel + 1) % m_levelNames.size()]); // Prefetched while this one was played
+	if (m_hotReload)
+		ReloadChangedLevels();
+	if (m_levelStreamer != NULL)
+		StreamSections();
+
+	// No simulation at all if framerate < 20 (usually the first few iterations) because it results in inacurrate updating (like Mario drops 300 pixels at beginning of level)
+	// The timers and the spawns follow the characters: no time passes in a frame that doesn't move them
+	const bool simulated = 1 / _dt > 20;
+	if (simulated)
 	{
-		if (it->second->GetPipeType() == SPAWN)
-			it->second->HandleSpawnEnemies(_dt);
+		m_timers.Advance(_dt);
+
+		// Spawn enemies from pipes
+		for (std::map<unsigned int, Pipe*>::iterator it = m_listPipes.begin(); it != m_listPipes.end(); ++it)
+		{
+			if (it->second->GetPipeType() == SPAWN)
+				it->second->HandleSpawnEnemies(_dt, m_renderCommands);
+		}
 	}
 
+	// Flat copy of the map for the collisions of this frame: every character goes through it. No item is added or deleted before DeleteAllDeadCharacters
+	FrameVector<DisplayableObject*> collisionCandidates;
+	collisionCandidates.reserve(m_listForegroundItems.size());
+	for (std::map<unsigned int, DisplayableObject*>::iterator it = m_listForegroundItems.begin(); it != m_listForegroundItems.end(); ++it)
+		collisionCandidates.push_back(it->second);
+
 	for (unsigned int i = 0; i < m_characters.size(); i++)
 	{
 		currentCharacter = m_characters[i];
 		if (currentCharacter != NULL)
 		{
-			if (1 / _dt > 20) // No updating at all if framerate < 20 (usually the first few iterations) because it results in inacurrate updating (like Mario drops 300 pixels at beginning of level)
+			if (simulated)
 				UpdateCharacterPosition(*currentCharacter, _dt);
 
-			HandleCollisions(*currentCharacter);
+			HandleCollisions(*currentCharacter, collisionCandidates);
 			SendCharacterPosition(i);
 		}
 	}
 	DeleteAllDeadCharacters();
+
+	m_renderCommands.Swap();
+	Event renderCommandsReady(&m_renderCommands);
+	m_eventEngine->dispatch(RENDER_COMMANDS_READY, &renderCommandsReady);
 }
 
-void GameEngine::UpdateForegroundItem(unsigned int _id, sf::FloatRect _coordinates)
+/* Queues the object for gfx, if it changed since the last time it was sent */
+void GameEngine::SendToGFX(DisplayableObject& _obj)
 {
-	auto DOtoUpdate = m_listForegroundItems.find(_id);
-	if (DOtoUpdate != m_listForegroundItems.end() && DOtoUpdate->second != NULL)
-		m_listForegroundItems[_id]->SetCoordinates(_coordinates);
+	RenderCommand command = _obj.GetRenderCommand();
+	if (_obj.DisplayInfoChanged(command))
+		m_renderCommands.Push(command);
 }
 
 void GameEngine::HandlePressedKey(sf::Keyboard::Key _key)
@@ -140,18 +153,15 @@ void GameEngine::HandlePressedKey(sf::Keyboard::Key _key)
 			}
 			break;
 		case sf::Keyboard::Escape:
-			if (m_indexMario == -1 && CanRespawnMario())
-			{
-				Player *mario = new Player(m_eventEngine, "mario", m_initPosMario);
-				AddCharacterToArray(mario);
-				m_listForegroundItems[mario->GetID()] = mario;
-
-				tmpEvent.SetString(m_currentLevelName);
-				m_eventEngine->dispatch(LEVEL_START, &tmpEvent);
-			}
+			if (m_levelStarted && CanRespawnMario())
+				RestartLevel();
 			break;
 		case sf::Keyboard::N:
-			m_listPipes[1]->ToggleSpawn();
+			if (m_listPipes.find(1) != m_listPipes.end()) // Not there if its section isn't loaded
+			{
+				m_levelTemplate.MarkModified(*m_listPipes[1]);
+				m_listPipes[1]->ToggleSpawn();
+			}
 			break;
 		default:
 			break;
@@ -198,22 +208,423 @@ void GameEngine::ToggleIgnoreUserInput(bool _ignore)
 void GameEngine::StoreLevelInfo(LevelInfo* _info)
 {
 	m_collisionHandler->SetLevelSize(_info->size);
+	m_levelInfo = *_info;
+}
+
+void GameEngine::SetLevelStreaming(bool _streaming)
+{
+	m_streamLevels = _streaming;
+	PrefetchNextLevel();
+}
+
+void GameEngine::SetCompiledLevels(bool _useCompiledLevels)
+{
+	m_useCompiledLevels = _useCompiledLevels;
+	PrefetchNextLevel();
+}
+
+void GameEngine::SetWriteCompiledLevels(bool _writeCompiledLevels)
+{
+	m_writeCompiledLevels = _writeCompiledLevels;
+	PrefetchNextLevel();
+}
+
+void GameEngine::SetLevels(const std::vector<std::string>& _lvlNames)
+{
+	if (_lvlNames.empty())
+		return;
+	m_levelNames = _lvlNames;
+	m_indexLevel = 0;
+	PrefetchNextLevel();
+	WatchLevels();
+}
+
+void GameEngine::SetHotReload(bool _hotReload)
+{
+	m_hotReload = _hotReload;
+	WatchLevels();
+}
+
+void GameEngine::WatchLevels()
+{
+	m_levelWatcher.Clear();
+	for (unsigned int i = 0; i < m_levelNames.size() && m_hotReload; i++)
+		m_levelWatcher.Watch(LevelImporter::GetFileName(m_levelNames[i]));
+}
+
+/* Start of each frame with hot reload: the current level gets what changed in its file, another level is prefetched again if it was */
+void GameEngine::ReloadChangedLevels()
+{
+	std::string fileName;
+	while (m_levelWatcher.PopChangedFile(fileName))
+	{
+		if (m_levelStarted && fileName == LevelImporter::GetFileName(m_currentLevelName))
+			ReloadLevel();
+		else
+		{
+			AllocationTripwire::ExpectedAllocations expectedAllocations; // The next level is prepared again
+			m_levelPrefetcher.Cancel();
+			PrefetchNextLevel();
+		}
+	}
+}
+
+/* The one after the current level, or the first one if no level is started. Nothing to prefetch for a streamed level: it's read by its own thread, as Mario moves */
+void GameEngine::PrefetchNextLevel()
+{
+	if (m_streamLevels || (m_levelStarted && m_levelNames.size() < 2))
+	{
+		m_levelPrefetcher.Cancel();
+		return;
+	}
+
+	unsigned int next = m_levelStarted ? (m_indexLevel + 1) % m_levelNames.size() : m_indexLevel;
+	m_levelPrefetcher.Prefetch(m_levelNames[next], m_useCompiledLevels, m_writeCompiledLevels);
+}
+
+/* Mario reached the right edge of the level, and there's another level to go to */
+bool GameEngine::IsLevelCompleted()
+{
+	if (m_indexMario == -1 || m_levelNames.size() < 2)
+		return false;
+	const MovingObject *mario = m_characters[m_indexMario];
+	return mario->GetPosition().x + mario->GetCoordinates().width >= m_levelInfo.size.x - 1; // He's stopped by the edge, see CollisionHandler
 }
 
+/* Only the objects are created here if the level was prefetched: it's already read and its tiles compressed (see LevelPrefetcher) */
 void GameEngine::StartLevel(std::string _lvlName)
 {
-	m_levelImporter->LoadLevel(_lvlName);
+	AllocationTripwire::ExpectedAllocations expectedAllocations;
+	sf::Clock clock;
+	if (m_levelStarted)
+		UnloadLevel();
+
 	m_currentLevelName = _lvlName;
+	PreparedLevel *prepared = NULL;
+	if (!m_streamLevels || !StartStreamedLevel(_lvlName))
+	{
+		prepared = m_levelPrefetcher.Take(_lvlName);
+		if (prepared != NULL)
+			m_levelImporter->LoadPreparedLevel(*prepared, m_newObjects);
+		else if (!m_useCompiledLevels || !m_levelImporter->LoadCompiledLevel(_lvlName, m_newObjects))
+			m_levelImporter->LoadLevel(_lvlName, m_newObjects);
+		m_levelTemplate.Record(m_levelInfo, m_newObjects);
+		RegisterLevel(m_newObjects);
+
+		m_tileMap.FinishLoading();
+		std::cout << "Level " << _lvlName << ": " << m_tileMap.GetNbTiles() << " tiles in " << m_tileMap.GetMemoryUsage() << " bytes" << std::endl;
+		Event tileMapLoaded(&m_tileMap);
+		m_eventEngine->dispatch(TILE_MAP_LOADED, &tileMapLoaded);
+	}
 
 	Event startLevel(_lvlName);
 	m_eventEngine->dispatch(LEVEL_START, &startLevel);
 
 	m_levelStarted = true;
+	std::vector<std::string>::iterator indexLevel = std::find(m_levelNames.begin(), m_levelNames.end(), _lvlName);
+	if (indexLevel != m_levelNames.end())
+		m_indexLevel = indexLevel - m_levelNames.begin();
+	PrefetchNextLevel();
+
+	std::cout << "Level " << _lvlName << " started in " << clock.getElapsedTime().asSeconds() * 1000 << " ms";
+	if (prepared != NULL)
+		std::cout << " (prepared in " << prepared->preparationTime << " ms on the worker thread)";
+	std::cout << std::endl;
+	delete prepared;
+}
+
+/*	Everything the level created goes, and gfx is told to remove the sprites. The characters are deleted one by one, as when they die,
+	the level items are not: they all go with the arena */
+void GameEngine::UnloadLevel()
+{
+	for (std::map<unsigned int, Pipe*>::iterator it = m_listPipes.begin(); it != m_listPipes.end(); ++it)
+		it->second->CancelSpawn(m_renderCommands);
+
+	for (std::map<unsigned int, DisplayableObject*>::iterator it = m_listForegroundItems.begin(); it != m_listForegroundItems.end(); ++it)
+	{
+		RenderCommand removeItem = it->second->GetRenderCommand();
+		removeItem.flags |= REMOVE_SPRITE;
+		m_renderCommands.Push(removeItem);
+	}
+
+	for (unsigned int i = 0; i < m_characters.size(); i++)
+		delete m_characters[i]; // Dead characters are already NULL, and out of m_listForegroundItems
+	m_characters.clear();
+	m_indexMario = -1;
+
+	m_listForegroundItems.clear();
+	m_listPipes.clear();
+	m_levelTemplate.Clear();
+	m_levelArena.Release();
+	m_tileMap.Clear();
+
+	if (m_levelStreamer != NULL)
+	{
+		m_levelStreamer->Close(); // The items of the loaded sections were in m_listForegroundItems, the sections' arenas go with them
+		delete m_levelStreamer;
+		m_levelStreamer = NULL;
+	}
+
+	m_levelStarted = false;
+}
+
+/*	Back to the start of the level, from its template: nothing is read again. The characters are all created again,
+	only the items the player changed are put back, and the tiles are left as they are: they can't change */
+void GameEngine::RestartLevel()
+{
+	if (m_levelTemplate.IsEmpty()) // Streamed: the sections behind Mario would have to be read again, he only comes back at the start
+	{
+		if (m_indexMario == -1)
+			RespawnMario();
+		return;
+	}
+
+	AllocationTripwire::ExpectedAllocations expectedAllocations;
+	sf::Clock clock;
+
+	for (unsigned int i = 0; i < m_characters.size(); i++)
+	{
+		if (m_characters[i] != NULL)
+			DeleteCharacter(i);
+	}
+	m_characters.clear();
+
+	unsigned int nbRestoredItems = m_levelTemplate.GetNbModifiedItems();
+	m_levelTemplate.RestoreModifiedItems([&](DisplayableObject& _item, Pipe* _pipe, State _initialState)
+	{
+		_item.SetState(_initialState);
+		if (_pipe != NULL)
+			_pipe->Reset(m_renderCommands);
+		SendToGFX(_item);
+	});
+
+	m_levelTemplate.CreateCharacters(m_eventEngine, m_newObjects);
+	RegisterLevel(m_newObjects);
+
+	Event startLevel(m_currentLevelName);
+	m_eventEngine->dispatch(LEVEL_START, &startLevel);
+
+	std::cout << "Level " << m_currentLevelName << " restarted in " << clock.getElapsedTime().asMicroseconds() << " us (" << nbRestoredItems << " items put back)" << std::endl;
+}
+
+/*	Only what changed in the file since the level was loaded is applied to it (see LevelImporter::ReloadLevel): the rest, Mario included, stays as the player left it
+	The template changes with it, for the next restart. A streamed level has no template: it's started again */
+void GameEngine::ReloadLevel()
+{
+	AllocationTripwire::ExpectedAllocations expectedAllocations;
+	sf::Clock clock;
+	if (m_levelTemplate.IsEmpty())
+	{
+		StartLevel(m_currentLevelName);
+		return;
+	}
+
+	LevelChanges changes;
+	if (!m_levelImporter->ReloadLevel(m_currentLevelName, m_levelTemplate, changes))
+		return; // Saved while it's edited: the level stays as it was until the next save
+
+	std::sort(changes.removedCharacters.begin(), changes.removedCharacters.end());
+	for (unsigned int i = 0; i < m_characters.size() && !changes.removedCharacters.empty(); i++)
+	{
+		if (m_characters[i] != NULL && (int)i != m_indexMario && std::binary_search(changes.removedCharacters.begin(), changes.removedCharacters.end(), m_characters[i]->GetID()))
+			DeleteCharacter(i);
+	}
+
+	for (unsigned int i = 0; i < changes.removedPipes.size(); i++)
+	{
+		changes.removedPipes[i]->CancelSpawn(m_renderCommands);
+		m_listPipes.erase(changes.removedPipes[i]->GetPipeId());
+	}
+
+	for (unsigned int i = 0; i < changes.removedItems.size(); i++)
+	{
+		RenderCommand removeItem = changes.removedItems[i]->GetRenderCommand();
+		removeItem.flags |= REMOVE_SPRITE;
+		m_renderCommands.Push(removeItem);
+		m_listForegroundItems.erase(changes.removedItems[i]->GetID());
+	}
+
+	for (unsigned int i = 0; i < changes.changedItems.size(); i++)
+	{
+		changes.changedItems[i].first->SetState(changes.changedItems[i].second);
+		SendToGFX(*changes.changedItems[i].first);
+	}
+
+	if (changes.marioMoved)
+		m_initPosMario = changes.initPosMario; // Where he comes back: he isn't moved now
+	RegisterLevel(changes.added);
+
+	if (changes.nbChangedTileColumns > 0)
+	{
+		Event tileMapLoaded(&m_tileMap);
+		m_eventEngine->dispatch(TILE_MAP_LOADED, &tileMapLoaded);
+	}
+
+	std::cout << "Level " << m_currentLevelName << " reloaded in " << clock.getElapsedTime().asSeconds() * 1000 << " ms: " << changes.GetNbObjectChanges() << " objects added, removed or changed, "
+		<< changes.nbChangedTileColumns << " columns of tiles encoded again" << std::endl;
+}
+
+void GameEngine::RespawnMario()
+{
+	AllocationTripwire::ExpectedAllocations expectedAllocations;
+	Player *mario = new Player(m_eventEngine, "mario", m_initPosMario);
+	AddCharacterToArray(mario);
+	m_listForegroundItems[mario->GetID()] = mario;
+
+	Event startLevel(m_currentLevelName);
+	m_eventEngine->dispatch(LEVEL_START, &startLevel);
+}
+
+/*	Only the index of the level file is built here (see LevelStreamer), then the sections around Mario are loaded.
+	Returns false if the file can't be read, for the level to be loaded in one go instead */
+bool GameEngine::StartStreamedLevel(std::string _lvlName)
+{
+	LevelInfo info;
+	sf::Vector2f initPosMario;
+	m_levelStreamer = new LevelStreamer();
+	if (!m_levelStreamer->Open(LevelImporter::GetFileName(_lvlName), info, initPosMario))
+	{
+		delete m_levelStreamer;
+		m_levelStreamer = NULL;
+		return false;
+	}
+
+	Event gotLvlInfo(&info);
+	m_eventEngine->dispatch(GOT_LVL_INFO, &gotLvlInfo);
+	m_tileMap.SetSize((unsigned int)info.size.x / TileMap::TileSize, (unsigned int)(info.size.y + TileMap::TileSize - 1) / TileMap::TileSize);
+
+	m_newObjects.characters.push_back(new Player(m_eventEngine, "mario", initPosMario));
+	RegisterLevel(m_newObjects);
+
+	m_streamingFocus = initPosMario.x;
+	StreamSections();
+	return true;
+}
+
+/* Start of each frame of a streamed level: the sections coming in view are created, the ones far behind (or ahead, after a respawn) go */
+void GameEngine::StreamSections()
+{
+	if (m_indexMario != -1)
+		m_streamingFocus = m_characters[m_indexMario]->GetPosition().x;
+
+	m_levelStreamer->Update(m_streamingFocus);
+
+	LevelSection *section = NULL;
+	bool tilesChanged = false;
+	while ((section = m_levelStreamer->PopSectionToEvict(m_streamingFocus)) != NULL)
+	{
+		EvictSection(*section);
+		tilesChanged = true;
+	}
+	while ((section = m_levelStreamer->PopReadySection()) != NULL)
+	{
+		LoadSection(*section);
+		tilesChanged = true;
+	}
+
+	if (tilesChanged)
+	{
+		AllocationTripwire::ExpectedAllocations expectedAllocations; // The columns of the sections are encoded again
+		m_tileMap.FinishLoading();
+		Event tileMapLoaded(&m_tileMap); // New types of tiles may have come with the section
+		m_eventEngine->dispatch(TILE_MAP_LOADED, &tileMapLoaded);
+	}
+}
+
+/* The objects of a section read by the loading thread are created, as LevelImporter does for a whole level */
+void GameEngine::LoadSection(LevelSection& _section)
+{
+	AllocationTripwire::ExpectedAllocations expectedAllocations;
+
+	for (unsigned int i = 0; i < _section.elements.size(); i++)
+	{
+		const LevelElement& element = _section.elements[i];
+		switch (element.kind)
+		{
+			case GOOMBA_ELEMENT:
+				m_newObjects.characters.push_back(new Goomba(m_eventEngine, element.sprite, element.position, element.direction));
+				_section.characters.push_back(m_newObjects.characters.back()->GetID());
+				break;
+			case BOX_ELEMENT:
+			{
+				std::map<unsigned int, State>::iterator savedState = _section.savedStates.find(i);
+				Box *box = _section.arena.Create<Box>(m_eventEngine, element.sprite, element.position, savedState != _section.savedStates.end() ? savedState->second : element.state);
+				_section.items.push_back(std::make_pair(i, (DisplayableObject*)box));
+				m_newObjects.items.push_back(box);
+				break;
+			}
+			case PIPE_ELEMENT:
+			{
+				unsigned int pipeId = (unsigned int)element.pipeId; // Pipes are found by unsigned id, as in m_listPipes
+				bool idTaken = m_listPipes.find(pipeId) != m_listPipes.end();
+				for (unsigned int j = 0; j < m_newObjects.pipes.size(); j++)
+					idTaken = idTaken || m_newObjects.pipes[j]->GetPipeId() == pipeId;
+				if (idTaken)
+				{
+					std::cerr << "Another pipe with id " << element.pipeId << " already exists. New pipe not created." << std::endl;
+					break;
+				}
+				Pipe *pipe = _section.arena.Create<Pipe>(element.sprite, element.position, element.pipeId, element.pipeType, m_eventEngine);
+				_section.items.push_back(std::make_pair(i, (DisplayableObject*)pipe));
+				_section.pipes.push_back(pipe);
+				m_newObjects.items.push_back(pipe);
+				m_newObjects.pipes.push_back(pipe);
+				break;
+			}
+			case FLOOR_ELEMENT:
+				if (element.position.x < m_tileMap.GetNbColumns() * TileMap::TileSize && element.position.y < m_tileMap.GetNbRows() * TileMap::TileSize) // The map has the size of the level
+					m_tileMap.AddTile(m_tileMap.GetTypeIndex(element.sprite), element.position);
+				break;
+			default:
+				break;
+		}
+	}
+
+	RegisterLevel(m_newObjects);
+	std::vector<LevelElement>().swap(_section.elements); // Read again from the file if the section is evicted and comes back
+}
+
+/*	Everything the section created goes, as in UnloadLevel. What the player changed (emptied boxes) is kept with the section for when it comes back,
+	the enemies are not: they are created again from the file. Its enemies go wherever they walked to, the ones of other sections stay even if they're in it */
+void GameEngine::EvictSection(LevelSection& _section)
+{
+	AllocationTripwire::ExpectedAllocations expectedAllocations;
+
+	for (unsigned int i = 0; i < _section.pipes.size(); i++)
+	{
+		_section.pipes[i]->CancelSpawn(m_renderCommands);
+		m_listPipes.erase(_section.pipes[i]->GetPipeId());
+	}
+
+	for (unsigned int i = 0; i < _section.items.size(); i++)
+	{
+		DisplayableObject *item = _section.items[i].second;
+		_section.savedStates[_section.items[i].first] = item->GetState();
+
+		RenderCommand removeItem = item->GetRenderCommand();
+		removeItem.flags |= REMOVE_SPRITE;
+		m_renderCommands.Push(removeItem);
+		m_listForegroundItems.erase(item->GetID());
+	}
+
+	for (unsigned int i = 0; i < m_characters.size() && !_section.characters.empty(); i++)
+	{
+		if (m_characters[i] != NULL && (int)i != m_indexMario && std::binary_search(_section.characters.begin(), _section.characters.end(), m_characters[i]->GetID()))
+			DeleteCharacter(i);
+	}
+
+	_section.characters.clear();
+	_section.items.clear();
+	_section.pipes.clear();
+	_section.arena.Release();
+	if (_section.index * TileMap::ChunkSize < m_tileMap.GetNbColumns()) // Sections out of the level have no tile
+		m_tileMap.ClearChunkColumn(_section.index);
 }
 
 /* Takes the place of the first NULL pointer (= dead character), or is pushed at the end */
 void GameEngine::AddCharacterToArray(MovingObject *_character)
 {
+	AllocationTripwire::ExpectedAllocations expectedAllocations; // Its place in the containers of g
 	int initialSize = m_characters.size();
 	int indexCharacter = -1;
 	for (int i = 0; i < initialSize; i++)
@@ -234,17 +645,76 @@ void GameEngine::AddCharacterToArray(MovingObject *_character)
 
 	if (_character->GetName() == "mario")
 		m_indexMario = indexCharacter;
+	else if (m_levelStreamer != NULL)
+	{
+		// Spawned by a pipe: it goes with the section it appeared in, or the one of the pipe when it came out at its edge
+		LevelSection *section = m_levelStreamer->GetNearestLoadedSection(_character->GetPosition().x);
+		if (section != NULL)
+			section->characters.push_back(_character->GetID());
+	}
 }
 
 void GameEngine::AddForegroundItemToArray(DisplayableObject *_item)
 {
-	m_listForegroundItems[_item->GetID()] = _item;
+	{
+		AllocationTripwire::ExpectedAllocations expectedAllocations; // Its node in m_listForegroundItems
+		m_listForegroundItems[_item->GetID()] = _item;
+	}
+	SendToGFX(*_item);
 }
 
-void GameEngine::AddPipeToArray(Pipe *_pipe)
+/*	Everything the importer created (or a section) is added at once. The maps are filled from ranges sorted by id, so each object goes at their end
+	instead of being searched from their root, and the objects are sent to gfx in the same order, for its maps too */
+void GameEngine::RegisterLevel(LevelDescription& _level)
 {
-	m_listPipes[_pipe->GetPipeId()] = _pipe;
-};
+	AllocationTripwire::ExpectedAllocations expectedAllocations;
+
+	std::vector<std::pair<unsigned int, DisplayableObject*> > objects;
+	objects.reserve(_level.characters.size() + _level.items.size());
+	for (unsigned int i = 0; i < _level.characters.size(); i++)
+		objects.push_back(std::make_pair(_level.characters[i]->GetID(), (DisplayableObject*)_level.characters[i]));
+	for (unsigned int i = 0; i < _level.items.size(); i++)
+		objects.push_back(std::make_pair(_level.items[i]->GetID(), _level.items[i]));
+	std::sort(objects.begin(), objects.end());
+	m_listForegroundItems.insert(objects.begin(), objects.end());
+
+	std::vector<std::pair<unsigned int, Pipe*> > pipes;
+	pipes.reserve(_level.pipes.size());
+	for (unsigned int i = 0; i < _level.pipes.size(); i++)
+		pipes.push_back(std::make_pair((unsigned int)_level.pipes[i]->GetPipeId(), _level.pipes[i]));
+	std::sort(pipes.begin(), pipes.end());
+	m_listPipes.insert(pipes.begin(), pipes.end());
+	for (unsigned int i = 0; i < _level.pipes.size(); i++)
+	{
+		if (_level.pipes[i]->GetPipeType() == SPAWN)
+			_level.pipes[i]->StartSpawning(m_timers);
+	}
+
+	// As in AddCharacterToArray, the places of the dead or evicted characters are taken first: sections coming and going don't grow m_characters
+	unsigned int freeIndex = 0;
+	for (unsigned int i = 0; i < _level.characters.size(); i++)
+	{
+		while (freeIndex < m_characters.size() && m_characters[freeIndex] != NULL)
+			freeIndex++;
+		if (freeIndex == m_characters.size())
+			m_characters.push_back(_level.characters[i]);
+		else
+			m_characters[freeIndex] = _level.characters[i];
+
+		if (_level.characters[i]->GetName() == "mario")
+		{
+			m_indexMario = freeIndex;
+			m_initPosMario = _level.characters[i]->GetPosition();
+		}
+		freeIndex++;
+	}
+
+	m_renderCommands.Reserve(objects.size());
+	for (unsigned int i = 0; i < objects.size(); i++)
+		SendToGFX(*objects[i].second);
+
+	_level.Clear();
+}
 
 void GameEngine::KillCharacter(unsigned int _characterID)
 {
@@ -263,16 +733,23 @@ void GameEngine::DeleteAllDeadCharacters()
 	for (unsigned int i = 0; i < m_characters.size(); i++)
 	{
 		if (m_characters[i] != NULL && m_characters[i]->IsDead())
-		{
-			m_listForegroundItems.erase(m_characters[i]->GetID());
+			DeleteCharacter(i);
+	}
+}
 
-			delete m_characters[i];
-			m_characters[i] = NULL;
+void GameEngine::DeleteCharacter(unsigned int _index)
+{
+	RenderCommand removeCharacter = m_characters[_index]->GetRenderCommand();
+	removeCharacter.flags |= REMOVE_SPRITE;
+	m_renderCommands.Push(removeCharacter);
 
-			if ((int)i == m_indexMario)
-				m_indexMario = -1;
-		}
-	}
+	m_listForegroundItems.erase(m_characters[_index]->GetID());
+
+	delete m_characters[_index];
+	m_characters[_index] = NULL;
+
+	if ((int)_index == m_indexMario)
+		m_indexMario = -1;
 }
 
 void GameEngine::UpdateCharacterPosition(MovingObject& _character, float _dt)
@@ -286,16 +763,14 @@ void GameEngine::UpdateCharacterPosition(MovingObject& _character, float _dt)
 	m_listForegroundItems[id]->SetY(pos.y);
 }
 
-// Broadcast character's position
+// Broadcast character's position, if it changed since the last frame
 void GameEngine::SendCharacterPosition(int _indexCharacter)
 {
 	MovingObject *character = m_characters[_indexCharacter];
 	if (character == NULL || character->IsDead())
 		return;
 
-	InfoForDisplay info = character->GetInfoForDisplay();
-	Event posInfo(&info);
-	m_eventEngine->dispatch(CHAR_POS_UPDATED, &posInfo);
+	SendToGFX(*character);
 #ifdef DEBUG_MODE
 	if (_indexCharacter == m_indexMario)
 	{
@@ -306,10 +781,10 @@ void GameEngine::SendCharacterPosition(int _indexCharacter)
 #endif
 }
 
-//	Handles collisions between the object and all the DisplayableObjects in m_listForegroundItems and with the map edges: detection and reaction.
-void GameEngine::HandleCollisions(MovingObject& _obj)
+//	Handles collisions between the object and all the DisplayableObjects in m_listForegroundItems (_candidates), the tiles around it and the map edges: detection and reaction.
+void GameEngine::HandleCollisions(MovingObject& _obj, const FrameVector<DisplayableObject*>& _candidates)
 {
-	if (m_listForegroundItems.size() <= 1)
+	if (_candidates.size() <= 1 && m_tileMap.GetNbTiles() == 0)
 		return;
 
 	CollisionDirection tmpDirection = NO_COL;
@@ -317,15 +792,20 @@ void GameEngine::HandleCollisions(MovingObject& _obj)
 	if (_obj.CanCollide())
 	{
 		// What happens if there is a collision so _obj is moved and there is another one and _obj is moved again ? The first collision would need to be handled again
-		for (std::map<unsigned int, DisplayableObject*>::iterator it = m_listForegroundItems.begin(); it != m_listForegroundItems.end(); ++it)
+		for (unsigned int i = 0; i < _candidates.size(); i++)
 		{
-			tmpDirection = m_collisionHandler->DetectCollisionWithObj(_obj, *(it->second));
+			tmpDirection = m_collisionHandler->DetectCollisionWithObj(_obj, *_candidates[i]);
 
 			if (tmpDirection != NO_COL)
 			{
-				m_collisionHandler->ReactToCollisionsWithObj(_obj, *(m_listForegroundItems[it->first]), tmpDirection);
+				State stateBefore = _candidates[i]->GetState();
+				m_collisionHandler->ReactToCollisionsWithObj(_obj, *_candidates[i], tmpDirection);
+				if (_candidates[i]->GetState() != stateBefore) // A box was emptied: put back by a restart
+					m_levelTemplate.MarkModified(*_candidates[i]);
 			}
 		}
+
+		m_collisionHandler->HandleCollisionsWithTiles(_obj, m_tileMap);
 	}
 
 	m_collisionHandler->HandleCollisionsWithMapEdges(_obj);
@@ -2,8 +2,14 @@
 #define GAMEENGINE_H
 
 #include "../System/Engine.hpp"
+#include "../System/FileWatcher.hpp"
+#include "../System/FrameArena.hpp"
+#include "../System/TimerWheel.hpp"
 #include "CollisionHandler.hpp"
 #include "LevelImporter.hpp"
+#include "LevelPrefetcher.hpp"
+#include "LevelStreamer.hpp"
+#include "LevelTemplate.hpp"
 #include "../System/Items/Box.hpp"
 #include "../System/Characters/Goomba.hpp"
 
@@ -18,14 +24,21 @@ class GameEngine : public Engine
 
 		void Frame();
 		void Frame(float _dt);
+		bool IsLevelStarted() const { return m_levelStarted; };
+		void SetLevelStreaming(bool _streaming); // Takes effect at the next level
+		void SetCompiledLevels(bool _useCompiledLevels); // Idem. The XML file is read if the level isn't compiled
+		void SetWriteCompiledLevels(bool _writeCompiledLevels); // A level that isn't compiled, or not anymore, is compiled to its file when it's read. Off by default
+		void SetLevels(const std::vector<std::string>& _lvlNames); // Played in this order: reaching the right edge of one starts the next
+		void SetHotReload(bool _hotReload); // The level files are watched: what changes in the current one is applied to it as it's played
+		void StartLevel(std::string _lvlName); // Prefetched or not
 
 		void StoreLevelInfo(LevelInfo* _info);
 
 		void AddCharacterToArray(MovingObject *_character);
 		void AddForegroundItemToArray(DisplayableObject *_item);
-		void AddPipeToArray(Pipe *_pipe);
+		void RegisterLevel(LevelDescription& _level);
 
-		void UpdateForegroundItem(unsigned int _id, sf::FloatRect _coordinates);
+		void SendToGFX(DisplayableObject& _obj);
 
 		void KillCharacter(unsigned int _characterID);
 
@@ -46,6 +59,22 @@ class GameEngine : public Engine
 
 		CollisionHandler *m_collisionHandler;
 		LevelImporter *m_levelImporter;
+		TimerWheel m_timers; // On the time of the simulation. Before the arena: the timers of the level items go before it
+		LevelArena m_levelArena; // The level items (boxes, pipes): freed together by UnloadLevel
+		TileMap m_tileMap; // The floor
+		LevelDescription m_newObjects; // Created by the importer or for a section, until they're registered
+		LevelTemplate m_levelTemplate; // What the level is restarted from. Empty for a streamed level
+		LevelStreamer *m_levelStreamer; // NULL unless the current level is streamed
+		LevelPrefetcher m_levelPrefetcher; // The next level, while the current one is played
+		std::vector<std::string> m_levelNames;
+		unsigned int m_indexLevel; // In m_levelNames, of the current level or the first one to start
+		LevelInfo m_levelInfo;
+		bool m_streamLevels;
+		bool m_useCompiledLevels;
+		bool m_writeCompiledLevels;
+		float m_streamingFocus; // Where Mario is or was last seen
+		FileWatcher m_levelWatcher; // The files of m_levelNames, if hot reload is on
+		bool m_hotReload;
 
 		sf::Vector2f m_initPosMario;
 		int m_indexMario; // Index of Mario in m_characters. -1 if he's not in it.
@@ -54,18 +83,32 @@ class GameEngine : public Engine
 		std::map<unsigned int, DisplayableObject*> m_listForegroundItems; // Part of the level the characters can be in collision with. Pointers stored to allow polymorphism.
 		std::map<unsigned int, Pipe*> m_listPipes;
 
+		RenderCommandBuffer m_renderCommands; // What changed during the frame, read by gfx in one go
+
 		bool CanRespawnMario();
 
 		void UpdateCharacterPosition(MovingObject& _character, float _dt);
 		void SendCharacterPosition(int _indexCharacter);
 
 		void DeleteAllDeadCharacters();
-
-		void StartLevel(std::string _lvlName);
+		void DeleteCharacter(unsigned int _index);
+
+		void UnloadLevel();
+		void RestartLevel();
+		void ReloadChangedLevels();
+		void ReloadLevel();
+		void WatchLevels();
+		void RespawnMario();
+		void PrefetchNextLevel();
+		bool IsLevelCompleted();
+		bool StartStreamedLevel(std::string _lvlName);
+		void StreamSections();
+		void LoadSection(LevelSection& _section);
+		void EvictSection(LevelSection& _section);
 		std::string m_currentLevelName;
 		bool m_levelStarted;
 
-		void HandleCollisions(MovingObject& _obj);
+		void HandleCollisions(MovingObject& _obj, const FrameVector<DisplayableObject*>& _candidates);
 
 		bool m_ignoreUserInput; // No input is taken into account while this sound is playing [see sound engine]
 
@@ -4,17 +4,14 @@
 * List of events sent by the Game Components
 */
 #define CHARACTER_DIED "game.character_died"
-#define CHAR_POS_UPDATED "game.character_position_updated"
 #define DEBUG_INFO_UPDATED "game.debug_info_updated"
 #define GOT_LVL_INFO "game.got_level_info"
-#define FOREGROUND_ITEM_REMOVED "game.foreground_item_removed"
-#define FOREGROUND_ITEM_UPDATED "game.foreground_item_updated"
 #define LEVEL_START "game.level_start"
 #define MARIO_JUMP "game.mario_jump"
 #define MARIO_KICKED_ENEMY "game.mario_kicked_enemy"
 #define NEW_CHARACTER_READ "game.new_character_read"
-#define NEW_FOREGROUND_ITEM_READ "game.new_foreground_item_read"
-#define NEW_PIPE_READ "game.new_pipe_read"
+#define RENDER_COMMANDS_READY "game.render_commands_ready"
+#define TILE_MAP_LOADED "game.tile_map_loaded"
 #define TOGGLE_IGNORE_INPUT "game.toggle_ignore_input"
 
 #endif // GAME_EVENTS_H
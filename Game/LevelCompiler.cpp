@@ -0,0 +1,394 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include "LevelCompiler.hpp"
+#include "GameEngine.hpp"
+#include "LevelImporter.hpp"
+#include "TileLayer.hpp"
+#include "../System/FileWatcher.hpp"
+#include "../System/MappedFile.hpp"
+#include "../System/XmlStreamReader.hpp"
+#include "../System/irrXML/irrXML.h"
+
+static_assert(sizeof(CompiledLevelHeader) == 112 && sizeof(CompiledObject) == 48 && sizeof(CompiledPipe) == 48, "The compiled level format changed: change CompiledLevelVersion too");
+
+bool LevelCompiler::Compile(const std::string& _lvlName)
+{
+	std::vector<char> file;
+	return Build(_lvlName, file) && Write(_lvlName, file);
+}
+
+bool LevelCompiler::Build(const std::string& _lvlName, std::vector<char>& _file)
+{
+	std::string xmlFileName = LevelImporter::GetFileName(_lvlName);
+	XmlStreamReader reader;
+	if (!reader.Open(xmlFileName))
+	{
+		std::cerr << "Can't read level file " << xmlFileName << std::endl;
+		return false;
+	}
+
+	CompiledLevelHeader header;
+	memset(&header, 0, sizeof(header));
+	std::vector<std::string> tileTypes;
+	std::vector<std::pair<sf::Vector2u, unsigned short> > tiles; // Cell, index in tileTypes
+	std::vector<CompiledObject> objects;
+	std::vector<CompiledPipe> pipes;
+	bool namesFit = true;
+
+	while (reader.Read())
+	{
+		if (reader.GetNodeType() != XML_ELEMENT)
+			continue;
+
+		std::string nodeName = reader.GetNodeName().ToString();
+		std::string sprite = reader.GetAttribute("sprite").ToString();
+		float x = reader.GetAttributeAsFloat("x");
+		float y = reader.GetAttributeAsFloat("y");
+
+		if (nodeName == "level")
+		{
+			header.width = reader.GetAttributeAsFloat("width");
+			header.height = reader.GetAttributeAsFloat("height");
+			namesFit = CopyName(reader.GetAttribute("background").ToString(), header.background) && namesFit;
+		}
+		else if (nodeName == "mario")
+		{
+			header.marioX = x;
+			header.marioY = y;
+		}
+		else if (nodeName == "goomba" || nodeName == "box")
+		{
+			CompiledObject object;
+			memset(&object, 0, sizeof(object));
+			object.x = x;
+			object.y = y;
+			if (nodeName == "goomba")
+			{
+				object.kind = GOOMBA_ELEMENT;
+				object.variant = reader.GetAttribute("direction").Equals("left") ? DLEFT : DRIGHT;
+				namesFit = CopyName("goomba", object.sprite) && namesFit;
+			}
+			else
+			{
+				object.kind = BOX_ELEMENT;
+				object.variant = reader.GetAttribute("state").Equals("empty") ? EMPTY : NORMAL;
+				namesFit = CopyName("item_" + sprite, object.sprite) && namesFit;
+			}
+			objects.push_back(object);
+		}
+		else if (nodeName == "pipe")
+		{
+			CompiledPipe pipe;
+			memset(&pipe, 0, sizeof(pipe));
+			pipe.id = reader.GetAttributeAsInt("id");
+			pipe.x = x;
+			pipe.y = y;
+			std::string type = reader.GetAttribute("type").ToString();
+			pipe.type = type == "spawn" ? SPAWN : type == "flower" ? FLOWER : TRAVEL;
+			namesFit = CopyName("item_" + sprite, pipe.sprite) && namesFit;
+
+			bool idTaken = false;
+			for (unsigned int i = 0; i < pipes.size(); i++)
+				idTaken = idTaken || pipes[i].id == pipe.id;
+			if (idTaken)
+				std::cerr << "Another pipe with id " << pipe.id << " already exists. New pipe not compiled." << std::endl;
+			else
+				pipes.push_back(pipe);
+		}
+		else if (nodeName == "floor_tile")
+		{
+			if (x < 0 || y < 0)
+			{
+				std::cerr << "Floor tile out of the level at " << x << ", " << y << ". Not compiled." << std::endl;
+				continue;
+			}
+			tiles.push_back(std::make_pair(sf::Vector2u((unsigned int)x / TileMap::TileSize, (unsigned int)y / TileMap::TileSize), GetTileType("floor_" + sprite, tileTypes)));
+		}
+		else if (nodeName == "tile_layer")
+		{
+			TileLayer layer;
+			if (!layer.Read(&reader))
+				continue;
+			sf::Vector2u corner((unsigned int)layer.GetX() / TileMap::TileSize, (unsigned int)layer.GetY() / TileMap::TileSize);
+			for (unsigned int row = 0; row < layer.GetNbRows(); row++)
+			{
+				for (unsigned int column = 0; column < layer.GetNbColumns(); column++)
+				{
+					if (layer.GetCell(column, row) != 0)
+						tiles.push_back(std::make_pair(corner + sf::Vector2u(column, row), GetTileType(layer.GetTileset()[layer.GetCell(column, row) - 1], tileTypes)));
+				}
+			}
+		}
+	}
+	reader.Close();
+
+	for (unsigned int i = 0; i < tileTypes.size(); i++)
+		namesFit = namesFit && tileTypes[i].size() < CompiledNameSize;
+	if (!namesFit)
+	{
+		std::cerr << "A sprite name is longer than " << CompiledNameSize - 1 << " characters: " << xmlFileName << " can't be compiled." << std::endl;
+		return false;
+	}
+
+	// The grid has the size of the level: checked before it's allocated, a missing attribute is -1
+	if (!(header.width >= TileMap::TileSize && header.height > 0)
+		|| (double)(header.width / TileMap::TileSize) * (double)(header.height / TileMap::TileSize + 1) > TileLayer::MaxNbCells)
+	{
+		std::cerr << "Level size " << header.width << "x" << header.height << " is invalid: " << xmlFileName << " can't be compiled." << std::endl;
+		return false;
+	}
+	header.nbColumns = (unsigned int)header.width / TileMap::TileSize;
+	header.nbRows = ((unsigned int)header.height + TileMap::TileSize - 1) / TileMap::TileSize;
+	std::vector<unsigned short> grid(header.nbColumns * header.nbRows, (unsigned short)TileMap::NoTile);
+	unsigned int nbTilesOut = 0;
+	for (unsigned int i = 0; i < tiles.size(); i++)
+	{
+		if (tiles[i].first.x >= header.nbColumns || tiles[i].first.y >= header.nbRows)
+			nbTilesOut++;
+		else
+			grid[tiles[i].first.y * header.nbColumns + tiles[i].first.x] = tiles[i].second; // Two tiles in the same cell: the last one read stays
+	}
+	if (nbTilesOut != 0)
+		std::cerr << nbTilesOut << " tiles out of the level in " << xmlFileName << ". Not compiled." << std::endl;
+
+	memcpy(header.magic, "SMLV", 4);
+	header.version = CompiledLevelVersion;
+	GetSourceInfo(xmlFileName, header.sourceTime, header.sourceSize);
+	header.nbTileTypes = tileTypes.size();
+	header.tileTypesOffset = sizeof(CompiledLevelHeader);
+	header.gridOffset = header.tileTypesOffset + tileTypes.size() * CompiledNameSize;
+	header.nbObjects = objects.size();
+	header.objectsOffset = (header.gridOffset + grid.size() * sizeof(unsigned short) + 3) & ~3u;
+	header.nbPipes = pipes.size();
+	header.pipesOffset = header.objectsOffset + objects.size() * sizeof(CompiledObject);
+	header.fileSize = header.pipesOffset + pipes.size() * sizeof(CompiledPipe);
+
+	_file.assign(header.fileSize, 0);
+	for (unsigned int i = 0; i < tileTypes.size(); i++)
+		CopyName(tileTypes[i], &_file[header.tileTypesOffset + i * CompiledNameSize]);
+	if (!grid.empty())
+		memcpy(&_file[header.gridOffset], &grid[0], grid.size() * sizeof(unsigned short));
+	if (!objects.empty())
+		memcpy(&_file[header.objectsOffset], &objects[0], objects.size() * sizeof(CompiledObject));
+	if (!pipes.empty())
+		memcpy(&_file[header.pipesOffset], &pipes[0], pipes.size() * sizeof(CompiledPipe));
+	header.checksum = 0;
+	memcpy(&_file[0], &header, sizeof(CompiledLevelHeader));
+	header.checksum = Checksum(&_file[0], _file.size());
+	memcpy(&_file[0], &header, sizeof(CompiledLevelHeader));
+	return true;
+}
+
+bool LevelCompiler::Write(const std::string& _lvlName, const std::vector<char>& _file)
+{
+	std::string compiledFileName = GetFileName(_lvlName);
+	std::ofstream output(compiledFileName.c_str(), std::ios::binary | std::ios::trunc);
+	output.write(&_file[0], _file.size());
+	if (!output)
+	{
+		std::cerr << "Can't write compiled level " << compiledFileName << std::endl;
+		return false;
+	}
+
+	const CompiledLevelHeader *header = (const CompiledLevelHeader*)&_file[0];
+	std::cout << "Compiled " << LevelImporter::GetFileName(_lvlName) << " (" << header->sourceSize << " bytes) into " << compiledFileName << " (" << _file.size() << " bytes)" << std::endl;
+	return true;
+}
+
+std::string LevelCompiler::GetFileName(const std::string& _lvlName)
+{
+	std::string xmlFileName = LevelImporter::GetFileName(_lvlName);
+	return xmlFileName.substr(0, xmlFileName.size() - 4) + ".lvl";
+}
+
+const CompiledLevelHeader* LevelCompiler::GetHeader(const char* _data, std::size_t _size)
+{
+	if (_data == NULL || _size < sizeof(CompiledLevelHeader))
+		return NULL;
+
+	const CompiledLevelHeader *header = (const CompiledLevelHeader*)_data;
+	if (memcmp(header->magic, "SMLV", 4) != 0 || header->version != CompiledLevelVersion || header->fileSize != _size)
+		return NULL;
+
+	// The header is in the checksum, with the checksum itself as 0: nothing in the file is read before it's checked
+	CompiledLevelHeader checkedHeader = *header;
+	checkedHeader.checksum = 0;
+	unsigned int checksum = Checksum((const char*)&checkedHeader, sizeof(CompiledLevelHeader));
+	if (Checksum(_data + sizeof(CompiledLevelHeader), _size - sizeof(CompiledLevelHeader), checksum) != header->checksum)
+		return NULL;
+
+	// Every table in the file, so that nothing read in place can be out of it
+	unsigned long long gridEnd = header->gridOffset + (unsigned long long)header->nbColumns * header->nbRows * sizeof(unsigned short);
+	if (header->tileTypesOffset + (unsigned long long)header->nbTileTypes * CompiledNameSize > _size || gridEnd > _size
+		|| header->objectsOffset + (unsigned long long)header->nbObjects * sizeof(CompiledObject) > _size
+		|| header->pipesOffset + (unsigned long long)header->nbPipes * sizeof(CompiledPipe) > _size
+		|| header->gridOffset % 2 != 0 || header->objectsOffset % 4 != 0 || header->pipesOffset % 4 != 0)
+		return NULL;
+
+	// Nor any value used as it is: names are C strings, cells are indexes, enums are cast
+	if (!IsName(header->background) || header->nbTileTypes >= TileMap::NoTile)
+		return NULL;
+	for (unsigned int i = 0; i < header->nbTileTypes; i++)
+	{
+		if (!IsName(_data + header->tileTypesOffset + i * CompiledNameSize))
+			return NULL;
+	}
+
+	const unsigned short *grid = (const unsigned short*)(_data + header->gridOffset);
+	for (unsigned long long i = 0; i < (unsigned long long)header->nbColumns * header->nbRows; i++)
+	{
+		if (grid[i] >= header->nbTileTypes && grid[i] != TileMap::NoTile)
+			return NULL;
+	}
+
+	const CompiledObject *objects = (const CompiledObject*)(_data + header->objectsOffset);
+	for (unsigned int i = 0; i < header->nbObjects; i++)
+	{
+		bool validVariant = objects[i].kind == GOOMBA_ELEMENT ? objects[i].variant <= DRIGHT : objects[i].variant <= EMPTY;
+		if ((objects[i].kind != GOOMBA_ELEMENT && objects[i].kind != BOX_ELEMENT) || !validVariant || !IsName(objects[i].sprite))
+			return NULL;
+	}
+
+	const CompiledPipe *pipes = (const CompiledPipe*)(_data + header->pipesOffset);
+	for (unsigned int i = 0; i < header->nbPipes; i++)
+	{
+		if (pipes[i].type > FLOWER || !IsName(pipes[i].sprite))
+			return NULL;
+	}
+
+	return header;
+}
+
+bool LevelCompiler::IsUpToDate(const CompiledLevelHeader& _header, const std::string& _xmlFileName)
+{
+	long long time;
+	unsigned int size;
+	if (!GetSourceInfo(_xmlFileName, time, size))
+		return true; // The compiled file is all there is
+	return time == _header.sourceTime && size == _header.sourceSize;
+}
+
+/* Same level loaded _nbRuns times from its XML file, then from its compiled file. The first load of each isn't counted: the file isn't in the cache of the system yet */
+void LevelCompiler::BenchmarkLoading(const std::string& _lvlName, unsigned int _nbRuns)
+{
+	MappedFile compiledFile;
+	if (!compiledFile.Open(GetFileName(_lvlName)) || GetHeader(compiledFile.GetData(), compiledFile.GetSize()) == NULL
+		|| !IsUpToDate(*GetHeader(compiledFile.GetData(), compiledFile.GetSize()), LevelImporter::GetFileName(_lvlName)))
+	{
+		compiledFile.Close();
+		if (!Compile(_lvlName))
+			return;
+	}
+	compiledFile.Close();
+
+	EventEngine eventEngine;
+	GameEngine gameEngine(&eventEngine);
+	sf::Clock clock;
+	float timeXML = 0;
+
+	for (int compiled = 0; compiled <= 1; compiled++)
+	{
+		gameEngine.SetCompiledLevels(compiled == 1);
+		gameEngine.StartLevel(_lvlName);
+
+		clock.restart();
+		for (unsigned int i = 0; i < _nbRuns; i++)
+			gameEngine.StartLevel(_lvlName);
+		float time = clock.getElapsedTime().asSeconds() * 1000 / _nbRuns;
+
+		if (compiled == 0)
+			timeXML = time;
+		else
+			std::cout << "Level " << _lvlName << ", " << _nbRuns << " loads. XML: " << timeXML << " ms per load, compiled: " << time << " ms per load" << std::endl;
+	}
+}
+
+/* Every node of an XML file read _nbRuns times by irrXML, then by XmlStreamReader. Both have to find the same elements, with the same x coordinates */
+void LevelCompiler::BenchmarkParsing(const std::string& _fileName, unsigned int _nbRuns)
+{
+	sf::Clock clock;
+	float times[2];
+	unsigned int nbElements[2] = { 0, 0 };
+	double sumX[2] = { 0, 0 };
+
+	for (int streamReader = 0; streamReader <= 1; streamReader++)
+	{
+		clock.restart();
+		for (unsigned int i = 0; i < _nbRuns; i++)
+		{
+			nbElements[streamReader] = 0;
+			sumX[streamReader] = 0;
+			if (streamReader == 0)
+			{
+				irr::io::IrrXMLReader *reader = irr::io::createIrrXMLReader(_fileName.c_str());
+				while (reader && reader->read())
+				{
+					if (reader->getNodeType() != irr::io::EXN_ELEMENT)
+						continue;
+					nbElements[0]++;
+					sumX[0] += reader->getAttributeValueAsFloat("x");
+				}
+				delete reader;
+			}
+			else
+			{
+				XmlStreamReader reader;
+				reader.Open(_fileName);
+				while (reader.Read())
+				{
+					if (reader.GetNodeType() != XML_ELEMENT)
+						continue;
+					nbElements[1]++;
+					sumX[1] += reader.GetAttributeAsFloat("x");
+				}
+			}
+		}
+		times[streamReader] = clock.getElapsedTime().asSeconds() * 1000 / _nbRuns;
+	}
+
+	std::cout << _fileName << ", " << nbElements[1] << " elements, " << _nbRuns << " reads. irrXML: " << times[0] << " ms per read, XmlStreamReader: " << times[1] << " ms per read" << std::endl;
+	if (nbElements[0] != nbElements[1] || sumX[0] != sumX[1])
+		std::cerr << "The readers don't agree: " << nbElements[0] << " elements for irrXML, " << nbElements[1] << " for XmlStreamReader" << std::endl;
+}
+
+/* FNV-1a. _hash is the checksum of what comes before _data, to go on with it */
+unsigned int LevelCompiler::Checksum(const char* _data, std::size_t _size, unsigned int _hash)
+{
+	unsigned int hash = _hash;
+	for (std::size_t i = 0; i < _size; i++)
+	{
+		hash ^= (unsigned char)_data[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+/* A file saved twice in the same second, with the same size, isn't the same file: the time is as precise as FileWatcher gets it */
+bool LevelCompiler::GetSourceInfo(const std::string& _xmlFileName, long long& _time, unsigned int& _size)
+{
+	return FileWatcher::GetFileInfo(_xmlFileName, _time, _size);
+}
+
+bool LevelCompiler::IsName(const char* _name)
+{
+	return memchr(_name, 0, CompiledNameSize) != NULL;
+}
+
+unsigned short LevelCompiler::GetTileType(const std::string& _spriteName, std::vector<std::string>& _tileTypes)
+{
+	unsigned short type = (unsigned short)(std::find(_tileTypes.begin(), _tileTypes.end(), _spriteName) - _tileTypes.begin());
+	if (type == _tileTypes.size())
+		_tileTypes.push_back(_spriteName);
+	return type;
+}
+
+bool LevelCompiler::CopyName(const std::string& _name, char* _destination)
+{
+	if (_name.size() >= CompiledNameSize)
+		return false;
+	memset(_destination, 0, CompiledNameSize);
+	memcpy(_destination, _name.c_str(), _name.size());
+	return true;
+}
@@ -0,0 +1,83 @@
+#ifndef LEVELCOMPILER_H
+#define LEVELCOMPILER_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "LevelStreamer.hpp"
+
+/*
+*	Compiled levels: the XML file of a level written once as a binary file (levels/NAME.lvl), which is mapped in memory and read in place,
+*	with nothing to parse: a header, the table of the tile types, the grid of the tiles and the tables of the objects and the pipes
+*	Everything is 4-byte aligned, in the byte order of the machine that compiled it
+*/
+
+static const unsigned int CompiledNameSize = 32;
+static const unsigned int CompiledLevelVersion = 2;
+
+struct CompiledLevelHeader
+{
+	char magic[4];				// "SMLV"
+	unsigned int version;
+	unsigned int checksum;		// FNV-1a of the whole file, this field being 0
+	unsigned int fileSize;
+	long long sourceTime;		// Modification time (in the most precise unit of the system) and size of the XML file: a level edited since it was compiled is read from the XML file
+	unsigned int sourceSize;
+	float width;
+	float height;
+	float marioX;
+	float marioY;
+	char background[CompiledNameSize];
+	unsigned int nbColumns;		// Of the tile grid
+	unsigned int nbRows;
+	unsigned int nbTileTypes;
+	unsigned int tileTypesOffset;	// char[CompiledNameSize] each: sprite names
+	unsigned int gridOffset;		// unsigned short each, row by row: index in the tile types or TileMap::NoTile
+	unsigned int nbObjects;
+	unsigned int objectsOffset;
+	unsigned int nbPipes;
+	unsigned int pipesOffset;
+};
+
+struct CompiledObject
+{
+	unsigned int kind;		// GOOMBA_ELEMENT or BOX_ELEMENT
+	unsigned int variant;	// Direction of a goomba, State of a box
+	float x;
+	float y;
+	char sprite[CompiledNameSize];
+};
+
+struct CompiledPipe
+{
+	int id;
+	unsigned int type;		// PipeType
+	float x;
+	float y;
+	char sprite[CompiledNameSize];
+};
+
+class LevelCompiler
+{
+	public:
+		static bool Compile(const std::string& _lvlName); // XML file -> compiled file
+		static bool Build(const std::string& _lvlName, std::vector<char>& _file); // XML file -> compiled level in memory, not written
+		static bool Write(const std::string& _lvlName, const std::vector<char>& _file);
+		static std::string GetFileName(const std::string& _lvlName);
+
+		/* Header of the compiled level in _data, if it's one of this version, complete and not corrupted, every table and value in it checked. NULL otherwise */
+		static const CompiledLevelHeader* GetHeader(const char* _data, std::size_t _size);
+		static bool IsUpToDate(const CompiledLevelHeader& _header, const std::string& _xmlFileName);
+
+		static void BenchmarkLoading(const std::string& _lvlName, unsigned int _nbRuns); // Both ways of loading a level, through GameEngine
+		static void BenchmarkParsing(const std::string& _fileName, unsigned int _nbRuns); // irrXML against XmlStreamReader on the same XML file
+
+	private:
+		static unsigned int Checksum(const char* _data, std::size_t _size, unsigned int _hash = 2166136261u);
+		static bool GetSourceInfo(const std::string& _xmlFileName, long long& _time, unsigned int& _size);
+		static bool CopyName(const std::string& _name, char* _destination);
+		static bool IsName(const char* _name); // Ends in its CompiledNameSize characters
+		static unsigned short GetTileType(const std::string& _spriteName, std::vector<std::string>& _tileTypes); // Index in _tileTypes, added if it's not there
+};
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef LEVELDESCRIPTION_H
+#define LEVELDESCRIPTION_H
+
+#include <vector>
+#include "../System/Items/Pipe.hpp"
+#include "../System/Characters/MovingObject.hpp"
+
+/*
+*	Everything LevelImporter created for a level (or LevelStreamer for a section), registered by GameEngine in one go
+*	The characters are on the heap, the items in an arena: GameEngine owns them once they're registered
+*/
+struct LevelDescription
+{
+	std::vector<MovingObject*> characters;
+	std::vector<DisplayableObject*> items;	// Boxes and pipes
+	std::vector<Pipe*> pipes;				// Also in items
+
+	void Clear()
+	{
+		characters.clear();
+		items.clear();
+		pipes.clear();
+	}
+};
+
+#endif
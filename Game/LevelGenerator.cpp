@@ -0,0 +1,200 @@
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include "LevelGenerator.hpp"
+#include "LevelImporter.hpp"
+
+/* The benchmark suite: a seed changed here is a different level, the results before and after aren't comparable anymore */
+const Scenario LevelGenerator::scenarios[] =
+{
+	{ "stress_wide",		{ 160000,	0.1f,	2000,	40,		300,	0.25f,	20150321 } },	// Mostly distance: sections, culling and the tile map
+	{ "stress_dense",		{ 8192,		0.6f,	400,	16,		60,		0.25f,	20150322 } },	// Many tiles around everyone: collisions with the tiles
+	{ "stress_enemy_swarm",	{ 8192,		0.05f,	40,		4,		400,	0,		20150323 } },	// Many characters: collisions between them
+	{ "stress_spawn_heavy",	{ 16384,	0.1f,	60,		200,	20,		1,		20150324 } }	// Every pipe spawns: creations and deletions every few frames
+};
+
+bool LevelGenerator::Generate(const std::string& _lvlName, const GeneratorSettings& _settings)
+{
+	unsigned int nbColumns = _settings.width / TileMap::TileSize;
+	unsigned int nbRows = LevelHeight / TileMap::TileSize;
+	if (nbColumns < StartColumns * 2)
+	{
+		std::cerr << "Level " << _lvlName << " can't be generated: it has to be at least " << StartColumns * 2 * TileMap::TileSize << " pixels wide" << std::endl;
+		return false;
+	}
+
+	std::mt19937 random(_settings.seed);
+	std::vector<bool> takenColumns(nbColumns, false); // On the ground: pipes and goombas
+	std::fill(takenColumns.begin(), takenColumns.begin() + StartColumns, true);
+
+	// Runs of 3 to 9 tiles (6 on average) with at least 2 cells between them: a run starts on a free cell with the probability giving the density
+	std::vector<unsigned short> platforms(nbColumns * ((NbPlatformRows - 1) * PlatformRowSpacing + 1), 0);
+	float density = std::min(std::max(_settings.tileDensity, 0.f), 0.7f);
+	unsigned int startProbability = (unsigned int)(density / (6 - 8 * density) * 65536);
+	unsigned int nbTiles = 0;
+	for (unsigned int i = 0; i < NbPlatformRows; i++)
+	{
+		unsigned short *row = &platforms[i * PlatformRowSpacing * nbColumns];
+		for (unsigned int column = 0; column < nbColumns; column++)
+		{
+			if (Random(random, 65536) >= startProbability)
+				continue;
+			unsigned int length = std::min(3 + Random(random, 7), nbColumns - column);
+			for (unsigned int j = 0; j < length; j++)
+				row[column + j] = j == 0 ? 1 : (j == length - 1 ? 3 : 2);
+			nbTiles += length;
+			column += length + 1;
+		}
+	}
+
+	unsigned int nbGroundRows = nbRows - GroundRow;
+	std::vector<unsigned short> ground(nbColumns * nbGroundRows, 2);
+	for (unsigned int row = 0; row < nbGroundRows; row++)
+	{
+		ground[row * nbColumns] = 1;
+		ground[row * nbColumns + nbColumns - 1] = 3;
+	}
+	nbTiles += ground.size();
+
+	std::string file = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<!-- Generated by LevelGenerator, seed " + std::to_string(_settings.seed) + " -->\n";
+	file += "<level height=\"" + std::to_string(LevelHeight) + "\" width=\"" + std::to_string(nbColumns * TileMap::TileSize) + "\" background=\"sky\" xmlns:xsi=\"http://www.w3.org/2001/XMLSchema-instance\"\n";
+	file += "xsi:noNamespaceSchemaLocation=\"levelSchema.xsd\">\n\t<characters>\n";
+	file += "\t\t<mario x=\"" + std::to_string(2 * TileMap::TileSize) + "\" y=\"" + std::to_string(GroundRow * TileMap::TileSize - 32) + "\"/>\n";
+
+	// The pipes are picked before the goombas: a goomba in a pipe couldn't get out of it
+	std::vector<unsigned int> pipeColumns = PickColumns(random, takenColumns, _settings.nbPipes, 2);
+	std::vector<unsigned int> goombaColumns = PickColumns(random, takenColumns, _settings.nbGoombas, 1);
+	for (unsigned int i = 0; i < goombaColumns.size(); i++)
+	{
+		file += "\t\t<goomba x=\"" + std::to_string(goombaColumns[i] * TileMap::TileSize) + "\" y=\"" + std::to_string((GroundRow - 1) * TileMap::TileSize) + "\"";
+		file += Random(random, 2) == 0 ? " direction=\"left\"/>\n" : " direction=\"right\"/>\n";
+	}
+	file += "\t</characters>\n\t<foreground>\n";
+
+	unsigned int nbSpawningPipes = 0;
+	for (unsigned int i = 0; i < pipeColumns.size(); i++)
+	{
+		bool spawning = Random(random, 65536) < (unsigned int)(_settings.spawnPipeRate * 65536);
+		nbSpawningPipes += spawning ? 1 : 0;
+		file += "\t\t<pipe x=\"" + std::to_string(pipeColumns[i] * TileMap::TileSize) + "\" y=\"" + std::to_string((GroundRow - 2) * TileMap::TileSize) + "\" sprite=\"green_pipe_h\"";
+		file += std::string(" type=\"") + (spawning ? "spawn" : "travel") + "\" id=\"" + std::to_string(i + 1) + "\"/>\n";
+	}
+
+	std::vector<bool> takenBoxColumns(nbColumns, false); // Boxes are above the ground items, they don't get in their way
+	std::vector<unsigned int> boxColumns = PickColumns(random, takenBoxColumns, _settings.nbBoxes, 1);
+	for (unsigned int i = 0; i < boxColumns.size(); i++)
+	{
+		unsigned int kind = Random(random, 4);
+		file += "\t\t<box x=\"" + std::to_string(boxColumns[i] * TileMap::TileSize) + "\" y=\"" + std::to_string(BoxRow * TileMap::TileSize) + "\"";
+		file += kind == 0 ? " sprite=\"question_box\"/>\n" : (kind == 1 ? " sprite=\"question_box_static\" state=\"empty\"/>\n" : " sprite=\"question_box_static\"/>\n");
+	}
+
+	WriteTiles(platforms, nbColumns, platforms.size() / nbColumns, FirstPlatformRow * TileMap::TileSize, file);
+	WriteTiles(ground, nbColumns, nbGroundRows, GroundRow * TileMap::TileSize, file);
+	file += "\t</foreground>\n</level>\n";
+
+	std::string fileName = LevelImporter::GetFileName(_lvlName);
+	std::ifstream previousFile(fileName.c_str(), std::ios::binary);
+	std::stringstream previousContent;
+	previousContent << previousFile.rdbuf();
+	if (previousFile && previousContent.str() == file)
+	{
+		std::cout << fileName << " is up to date" << std::endl;
+		return true;
+	}
+	previousFile.close();
+
+	std::ofstream output(fileName.c_str(), std::ios::binary | std::ios::trunc);
+	output << file;
+	if (!output)
+	{
+		std::cerr << "Can't write generated level " << fileName << std::endl;
+		return false;
+	}
+
+	std::cout << "Generated " << fileName << ": " << nbColumns * TileMap::TileSize << " pixels, " << nbTiles << " tiles, " << boxColumns.size() << " boxes, "
+		<< pipeColumns.size() << " pipes (" << nbSpawningPipes << " spawning), " << goombaColumns.size() << " goombas" << std::endl;
+	return true;
+}
+
+bool LevelGenerator::GenerateScenario(const std::string& _scenarioName)
+{
+	const Scenario *scenario = GetScenario(_scenarioName);
+	if (scenario == NULL)
+	{
+		std::cerr << "Unknown scenario " << _scenarioName << ". Scenarios:";
+		for (unsigned int i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++)
+			std::cerr << " " << scenarios[i].name;
+		std::cerr << std::endl;
+		return false;
+	}
+	return Generate(scenario->name, scenario->settings);
+}
+
+bool LevelGenerator::GenerateScenarios()
+{
+	bool generated = true;
+	for (unsigned int i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++)
+		generated = Generate(scenarios[i].name, scenarios[i].settings) && generated;
+	return generated;
+}
+
+const Scenario* LevelGenerator::GetScenario(const std::string& _scenarioName)
+{
+	for (unsigned int i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); i++)
+	{
+		if (_scenarioName == scenarios[i].name)
+			return &scenarios[i];
+	}
+	return NULL;
+}
+
+/* Not std::uniform_int_distribution: its results aren't the same from one standard library to another, std::mt19937's are */
+unsigned int LevelGenerator::Random(std::mt19937& _random, unsigned int _max)
+{
+	return (unsigned int)(_random() % _max);
+}
+
+/* As a rle tile layer (see TileLayer), with the tileset of the floor of the hand-written levels */
+void LevelGenerator::WriteTiles(const std::vector<unsigned short>& _cells, unsigned int _nbColumns, unsigned int _nbRows, unsigned int _y, std::string& _file)
+{
+	_file += "\t\t<tile_layer x=\"0\" y=\"" + std::to_string(_y) + "\" columns=\"" + std::to_string(_nbColumns) + "\" rows=\"" + std::to_string(_nbRows) + "\" tileset=\"left middle right\" encoding=\"rle\">";
+	for (unsigned int i = 0; i < _cells.size(); )
+	{
+		unsigned int count = 1;
+		while (i + count < _cells.size() && _cells[i + count] == _cells[i])
+			count++;
+		if (i > 0)
+			_file += ",";
+		if (count > 1)
+			_file += std::to_string(count) + "*";
+		_file += std::to_string(_cells[i]);
+		i += count;
+	}
+	_file += "</tile_layer>\n";
+}
+
+/* Up to _nbColumns places of _width columns, all free, in a random order then sorted: the file goes from left to right */
+std::vector<unsigned int> LevelGenerator::PickColumns(std::mt19937& _random, std::vector<bool>& _taken, unsigned int _nbColumns, unsigned int _width)
+{
+	std::vector<unsigned int> candidates;
+	for (unsigned int column = 0; column + _width <= _taken.size(); column += _width)
+	{
+		bool free = true;
+		for (unsigned int i = 0; i < _width; i++)
+			free = free && !_taken[column + i];
+		if (free)
+			candidates.push_back(column);
+	}
+
+	unsigned int nbPicked = std::min(_nbColumns, (unsigned int)candidates.size());
+	for (unsigned int i = 0; i < nbPicked; i++)
+		std::swap(candidates[i], candidates[i + Random(_random, candidates.size() - i)]);
+	candidates.resize(nbPicked);
+	std::sort(candidates.begin(), candidates.end());
+
+	for (unsigned int i = 0; i < candidates.size(); i++)
+		std::fill(_taken.begin() + candidates[i], _taken.begin() + candidates[i] + _width, true);
+	return candidates;
+}
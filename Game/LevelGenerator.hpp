@@ -0,0 +1,56 @@
+#ifndef LEVELGENERATOR_H
+#define LEVELGENERATOR_H
+
+#include <random>
+#include <string>
+#include <vector>
+
+/* What a generated level is made of. The same settings always give the same file */
+struct GeneratorSettings
+{
+	unsigned int width;		// In pixels, rounded down to whole tiles
+	float tileDensity;		// Share of the rows of platforms covered by tiles, from 0 to 1
+	unsigned int nbBoxes;
+	unsigned int nbPipes;
+	unsigned int nbGoombas;
+	float spawnPipeRate;	// Share of the pipes spawning goombas, from 0 to 1. The others are travel pipes
+	unsigned int seed;
+};
+
+struct Scenario
+{
+	const char* name;
+	GeneratorSettings settings;
+};
+
+/*
+*	Levels written as XML files (see levelSchema.xsd), to stress what the hand-written ones don't: collisions, drawing and spawning
+*	The floor is a tile layer under the whole level, with rows of platforms above it. Boxes, pipes and goombas are spread over the width,
+*	never on top of each other, and away from Mario at the start
+*	The benchmark scenarios are fixed by their seeds: each one is generated as levels/NAME.xml and played like any other level
+*/
+class LevelGenerator
+{
+	public:
+		static bool Generate(const std::string& _lvlName, const GeneratorSettings& _settings); // The file isn't written again if it didn't change: its compiled level is kept
+		static bool GenerateScenario(const std::string& _scenarioName);
+		static bool GenerateScenarios();
+		static const Scenario* GetScenario(const std::string& _scenarioName); // NULL if there is none with that name
+
+	private:
+		static const unsigned int LevelHeight = 464;
+		static const unsigned int GroundRow = 26;		// The floor is from this row to the bottom of the level
+		static const unsigned int FirstPlatformRow = 6;
+		static const unsigned int PlatformRowSpacing = 4;
+		static const unsigned int NbPlatformRows = 3;
+		static const unsigned int BoxRow = 22;
+		static const unsigned int StartColumns = 12;	// Where Mario starts: nothing else there
+
+		static const Scenario scenarios[];
+
+		static unsigned int Random(std::mt19937& _random, unsigned int _max); // From 0 to _max - 1, the same for a seed on every platform
+		static void WriteTiles(const std::vector<unsigned short>& _cells, unsigned int _nbColumns, unsigned int _nbRows, unsigned int _y, std::string& _file);
+		static std::vector<unsigned int> PickColumns(std::mt19937& _random, std::vector<bool>& _taken, unsigned int _nbColumns, unsigned int _width); // Free columns, taken after
+};
+
+#endif
@@ -1,31 +1,39 @@
+#include <algorithm>
 #include <cstring>
 #include "LevelImporter.hpp"
 #include "GameEngine.hpp"
 #include "GameEvents.hpp"
-
-using namespace irr;
-using namespace io;
+#include "LevelCompiler.hpp"
+#include "LevelPrefetcher.hpp"
+#include "TileLayer.hpp"
+#include "../System/MappedFile.hpp"
+#include "../System/SpriteRegistry.hpp"
 
 const std::string LevelImporter::levelsPath = "levels/";
 
-LevelImporter::LevelImporter(EventEngine *_eventEngine)
+LevelImporter::LevelImporter(EventEngine *_eventEngine, LevelArena *_levelArena, TileMap *_tileMap)
 {
 	m_eventEngine = _eventEngine;
+	m_levelArena = _levelArena;
+	m_tileMap = _tileMap;
+	m_level = NULL;
 }
 
-bool LevelImporter::LoadLevel(std::string _lvlName)
+bool LevelImporter::LoadLevel(std::string _lvlName, LevelDescription& _level)
 {
 	bool fileNotEmpty = false;
-	std::string lvlFullName = LevelImporter::levelsPath + _lvlName + ".xml";
-	m_lvlFile = createIrrXMLReader(lvlFullName.c_str());
+	m_level = &_level;
+	std::string lvlFullName = GetFileName(_lvlName);
+	m_pipeIds.clear();
+	m_lvlFile.Open(lvlFullName);
 
-	while (m_lvlFile && m_lvlFile->read())
+	while (m_lvlFile.Read())
 	{
 		fileNotEmpty = true;
-		switch (m_lvlFile->getNodeType())
+		switch (m_lvlFile.GetNodeType())
 		{
-			case EXN_ELEMENT:
-				if (!strcmp("level", m_lvlFile->getNodeName()))
+			case XML_ELEMENT:
+				if (m_lvlFile.GetNodeName().Equals("level"))
 				{
 					LevelInfo info;
 					info.backgroundName = GetAttributeValue("background");
@@ -35,9 +43,9 @@ bool LevelImporter::LoadLevel(std::string _lvlName)
 					Event gotLvlInfo(&info);
 					m_eventEngine->dispatch(GOT_LVL_INFO, &gotLvlInfo);
 				}
-				if (!strcmp("characters", m_lvlFile->getNodeName()))
+				if (m_lvlFile.GetNodeName().Equals("characters"))
 					StoreCharactersInitialPositions();
-				if (!strcmp("foreground", m_lvlFile->getNodeName()))
+				if (m_lvlFile.GetNodeName().Equals("foreground"))
 					StoreListForegroundTileNames();
 				break;
 			default:
@@ -45,48 +53,289 @@ bool LevelImporter::LoadLevel(std::string _lvlName)
 		}
 	}
 
+	m_lvlFile.Close();
+	m_level = NULL;
+
 	if (!fileNotEmpty)
 	{
 		std::cerr << "Can't read level file " << lvlFullName << std::endl;
 		return false;
 	}
+	return true;
+}
+
+/* Same as LoadLevel, but everything is read in place from the mapped file */
+bool LevelImporter::LoadCompiledLevel(std::string _lvlName, LevelDescription& _level)
+{
+	MappedFile file;
+	if (!file.Open(LevelCompiler::GetFileName(_lvlName)))
+		return false;
+
+	const CompiledLevelHeader *header = LevelCompiler::GetHeader(file.GetData(), file.GetSize());
+	if (header == NULL)
+	{
+		std::cerr << "Compiled level " << LevelCompiler::GetFileName(_lvlName) << " is invalid. Compile it again." << std::endl;
+		return false;
+	}
+	if (!LevelCompiler::IsUpToDate(*header, GetFileName(_lvlName)))
+	{
+		std::cerr << "Compiled level " << LevelCompiler::GetFileName(_lvlName) << " is older than its XML file. Compile it again." << std::endl;
+		return false;
+	}
+
+	CreateCompiledObjects(*header, file.GetData(), _level);
+
+	std::vector<unsigned short> typeIndexes(header->nbTileTypes);
+	for (unsigned int i = 0; i < header->nbTileTypes; i++)
+		typeIndexes[i] = m_tileMap->GetTypeIndex(file.GetData() + header->tileTypesOffset + i * CompiledNameSize);
+	m_tileMap->LoadGrid((const unsigned short*)(file.GetData() + header->gridOffset), header->nbColumns, header->nbRows, typeIndexes);
+
+	return true;
+}
+
+/* Its tiles are already compressed (see LevelPrefetcher): only the objects are left to create, and the types of the tiles */
+void LevelImporter::LoadPreparedLevel(PreparedLevel& _prepared, LevelDescription& _level)
+{
+	const CompiledLevelHeader *header = (const CompiledLevelHeader*)&_prepared.data[0];
+	CreateCompiledObjects(*header, &_prepared.data[0], _level);
+
+	// The worker thread can't create the types (SpriteRegistry is only used by this one): they're created in the order of the table, the tiles are indexes in it
+	m_tileMap->Clear();
+	std::swap(*m_tileMap, _prepared.tiles);
+	for (unsigned int i = 0; i < header->nbTileTypes; i++)
+	{
+		unsigned short typeIndex = m_tileMap->GetTypeIndex(&_prepared.data[header->tileTypesOffset + i * CompiledNameSize]);
+		assert(typeIndex == i);
+	}
+}
+
+void LevelImporter::CreateCompiledObjects(const CompiledLevelHeader& _header, const char* _data, LevelDescription& _level)
+{
+	LevelInfo info;
+	info.backgroundName = _header.background;
+	info.size.x = _header.width;
+	info.size.y = _header.height;
+	Event gotLvlInfo(&info);
+	m_eventEngine->dispatch(GOT_LVL_INFO, &gotLvlInfo);
+
+	_level.characters.reserve(_level.characters.size() + _header.nbObjects + 1);
+	_level.items.reserve(_level.items.size() + _header.nbObjects + _header.nbPipes);
+	_level.pipes.reserve(_level.pipes.size() + _header.nbPipes);
+	_level.characters.push_back(new Player(m_eventEngine, "mario", sf::Vector2f(_header.marioX, _header.marioY)));
+
+	const CompiledObject *objects = (const CompiledObject*)(_data + _header.objectsOffset);
+	for (unsigned int i = 0; i < _header.nbObjects; i++)
+		CreateCompiledObject(objects[i], _level);
+
+	const CompiledPipe *pipes = (const CompiledPipe*)(_data + _header.pipesOffset);
+	for (unsigned int i = 0; i < _header.nbPipes; i++)
+		CreateCompiledPipe(pipes[i], _level);
+}
+
+void LevelImporter::CreateCompiledObject(const CompiledObject& _object, LevelDescription& _level)
+{
+	if (_object.kind == GOOMBA_ELEMENT)
+		_level.characters.push_back(new Goomba(m_eventEngine, _object.sprite, _object.x, _object.y, (Direction)_object.variant));
+	else if (_object.kind == BOX_ELEMENT)
+		_level.items.push_back(m_levelArena->Create<Box>(m_eventEngine, _object.sprite, _object.x, _object.y, (State)_object.variant));
+}
+
+void LevelImporter::CreateCompiledPipe(const CompiledPipe& _pipe, LevelDescription& _level)
+{
+	Pipe *pipe = m_levelArena->Create<Pipe>(_pipe.sprite, sf::Vector2f(_pipe.x, _pipe.y), _pipe.id, (PipeType)_pipe.type, m_eventEngine);
+	_level.items.push_back(pipe);
+	_level.pipes.push_back(pipe);
+}
+
+/* An element of the level, in the template or in the new file: the same key on both sides is the same element */
+struct ReloadedElement
+{
+	unsigned int kind;		// LevelElementKind
+	float x;
+	float y;
+	unsigned int spriteId;
+	int variant;			// Direction of a goomba, type and id of a pipe: another one is another element. Not the state of a box: it's changed in place
+	unsigned int index;		// In the characters then the items of the template, or in the objects then the pipes of the file
+
+	bool operator<(const ReloadedElement& _other) const
+	{
+		if (kind != _other.kind)
+			return kind < _other.kind;
+		if (x != _other.x)
+			return x < _other.x;
+		if (y != _other.y)
+			return y < _other.y;
+		if (spriteId != _other.spriteId)
+			return spriteId < _other.spriteId;
+		return variant < _other.variant;
+	};
+};
+
+/*	The new file is compiled in memory (see LevelCompiler::Build), then both sides are sorted by key and walked together: what's only in the template is removed,
+	what's only in the file is created, a box in both only gets its new state. Only the objects that changed are created or removed, but finding them costs
+	a whole Build of the file and two sorts of all its elements: O(n log n) in the size of the level on each save, not in the size of the edit.
+	The tiles are compared column of chunks by column of chunks (see TileMap::UpdateGrid), each column of the level is read */
+bool LevelImporter::ReloadLevel(const std::string& _lvlName, LevelTemplate& _template, LevelChanges& _changes)
+{
+	std::vector<char> file;
+	if (!LevelCompiler::Build(_lvlName, file))
+		return false;
+	const CompiledLevelHeader *header = (const CompiledLevelHeader*)&file[0];
+	const CompiledObject *objects = (const CompiledObject*)(&file[0] + header->objectsOffset);
+	const CompiledPipe *pipes = (const CompiledPipe*)(&file[0] + header->pipesOffset);
+
+	LevelInfo info = _template.GetLevelInfo();
+	if (info.backgroundName != header->background || info.size != sf::Vector2f(header->width, header->height)) // Sent again only then: gfx puts the camera back at the start
+	{
+		info.backgroundName = header->background;
+		info.size = sf::Vector2f(header->width, header->height);
+		_template.SetLevelInfo(info);
+		Event gotLvlInfo(&info);
+		m_eventEngine->dispatch(GOT_LVL_INFO, &gotLvlInfo);
+		_changes.levelInfoChanged = true;
+	}
+
+	const std::vector<LevelTemplate::TemplateCharacter>& characters = _template.GetCharacters();
+	const std::vector<LevelTemplate::TemplateItem>& items = _template.GetItems();
+	std::vector<ReloadedElement> before;
+	before.reserve(characters.size() + items.size());
+	for (unsigned int i = 0; i < characters.size(); i++)
+	{
+		if (characters[i].name == "mario")
+		{
+			sf::Vector2f initPosMario(header->marioX, header->marioY);
+			_changes.marioMoved = characters[i].position != initPosMario;
+			_changes.initPosMario = initPosMario;
+			_template.SetCharacterPosition(i, initPosMario);
+			continue;
+		}
+		ReloadedElement element = { GOOMBA_ELEMENT, characters[i].position.x, characters[i].position.y, characters[i].spriteId, characters[i].direction, i };
+		before.push_back(element);
+	}
+	for (unsigned int i = 0; i < items.size(); i++)
+	{
+		const sf::Vector2f position = items[i].item->GetPosition();
+		ReloadedElement element = { BOX_ELEMENT, position.x, position.y, items[i].spriteId, 0, (unsigned int)characters.size() + i };
+		if (items[i].pipe != NULL)
+		{
+			element.kind = PIPE_ELEMENT;
+			element.variant = items[i].pipe->GetPipeId() * 4 + items[i].pipe->GetPipeType();
+		}
+		before.push_back(element);
+	}
+
+	std::vector<ReloadedElement> after;
+	after.reserve(header->nbObjects + header->nbPipes);
+	for (unsigned int i = 0; i < header->nbObjects; i++)
+	{
+		ReloadedElement element = { objects[i].kind, objects[i].x, objects[i].y, SpriteRegistry::GetId(objects[i].sprite), objects[i].kind == GOOMBA_ELEMENT ? (int)objects[i].variant : 0, i };
+		after.push_back(element);
+	}
+	for (unsigned int i = 0; i < header->nbPipes; i++)
+	{
+		ReloadedElement element = { PIPE_ELEMENT, pipes[i].x, pipes[i].y, SpriteRegistry::GetId(pipes[i].sprite), pipes[i].id * 4 + (int)pipes[i].type, header->nbObjects + i };
+		after.push_back(element);
+	}
+
+	std::sort(before.begin(), before.end());
+	std::sort(after.begin(), after.end());
+
+	std::vector<bool> removedCharacters(characters.size(), false);
+	std::vector<bool> removedItems(items.size(), false);
+	unsigned int i = 0, j = 0;
+	while (i < before.size() || j < after.size())
+	{
+		if (j == after.size() || (i < before.size() && before[i] < after[j]))
+		{
+			unsigned int index = before[i++].index;
+			if (index < characters.size())
+			{
+				removedCharacters[index] = true;
+				_changes.removedCharacters.push_back(characters[index].id);
+			}
+			else
+			{
+				removedItems[index - characters.size()] = true;
+				_changes.removedItems.push_back(items[index - characters.size()].item);
+				if (items[index - characters.size()].pipe != NULL)
+					_changes.removedPipes.push_back(items[index - characters.size()].pipe);
+			}
+		}
+		else if (i == before.size() || after[j] < before[i])
+		{
+			unsigned int index = after[j++].index;
+			if (index < header->nbObjects)
+				CreateCompiledObject(objects[index], _changes.added);
+			else
+				CreateCompiledPipe(pipes[index - header->nbObjects], _changes.added);
+		}
+		else
+		{
+			if (before[i].kind == BOX_ELEMENT)
+			{
+				unsigned int index = before[i].index - characters.size();
+				State state = (State)objects[after[j].index].variant;
+				if (items[index].state != state)
+				{
+					_template.SetItemState(index, state);
+					_changes.changedItems.push_back(std::make_pair(items[index].item, state));
+				}
+			}
+			i++;
+			j++;
+		}
+	}
+
+	_template.Remove(removedCharacters, removedItems);
+	_template.Add(_changes.added);
+
+	std::vector<unsigned short> typeIndexes(header->nbTileTypes);
+	for (unsigned int k = 0; k < header->nbTileTypes; k++)
+		typeIndexes[k] = m_tileMap->GetTypeIndex(&file[header->tileTypesOffset + k * CompiledNameSize]);
+	const unsigned short *grid = (const unsigned short*)(&file[0] + header->gridOffset);
+	if (header->nbColumns == m_tileMap->GetNbColumns() && header->nbRows == m_tileMap->GetNbRows())
+		_changes.nbChangedTileColumns = m_tileMap->UpdateGrid(grid, typeIndexes);
+	else
+	{
+		m_tileMap->LoadGrid(grid, header->nbColumns, header->nbRows, typeIndexes); // Bigger or smaller: the grid is made again
+		_changes.nbChangedTileColumns = (header->nbColumns + TileMap::ChunkSize - 1) / TileMap::ChunkSize;
+	}
 
-	delete m_lvlFile;
-	m_lvlFile = NULL;
 	return true;
 }
 
+std::string LevelImporter::GetFileName(const std::string& _lvlName)
+{
+	return LevelImporter::levelsPath + _lvlName + ".xml";
+}
+
 void LevelImporter::StoreCharactersInitialPositions()
 {
 	bool foundOneCharacter = false;
-	const char* nodeName;
+	XmlStringView nodeName;
 
-	while (m_lvlFile && m_lvlFile->read())
+	while (m_lvlFile.Read())
 	{
-		switch (m_lvlFile->getNodeType())
+		switch (m_lvlFile.GetNodeType())
 		{
-			case EXN_ELEMENT:
+			case XML_ELEMENT:
 				foundOneCharacter = true;
-				nodeName = m_lvlFile->getNodeName();
-				if (!strcmp("mario", nodeName))
+				nodeName = m_lvlFile.GetNodeName();
+				if (nodeName.Equals("mario"))
 				{
 					sf::Vector2f initPosMario;
 					initPosMario.x = GetAttributeValueAsFloat("x");
 					initPosMario.y = GetAttributeValueAsFloat("y");
 
-					Player *mario = new Player(m_eventEngine, "mario", initPosMario);
-					Event newMario(mario);
-					m_eventEngine->dispatch(NEW_CHARACTER_READ, &newMario);
+					m_level->characters.push_back(new Player(m_eventEngine, "mario", initPosMario));
 				}
-				if (!strcmp("goomba", nodeName))
+				if (nodeName.Equals("goomba"))
 				{
 					Direction tmpDir = GetAttributeValue("direction", true) == "left" ? DLEFT : DRIGHT; // direction = right if attribute not here
-					Goomba *goomba = new Goomba(m_eventEngine, "goomba", GetAttributeValueAsFloat("x"), GetAttributeValueAsFloat("y"), tmpDir);
-					Event newGoomba(goomba);
-					m_eventEngine->dispatch(NEW_CHARACTER_READ, &newGoomba);
+					m_level->characters.push_back(new Goomba(m_eventEngine, "goomba", GetAttributeValueAsFloat("x"), GetAttributeValueAsFloat("y"), tmpDir));
 				}
 				break;
-			case EXN_ELEMENT_END:
+			case XML_ELEMENT_END:
 				if (!foundOneCharacter)
 					std::cerr << "No character in level file." << std::endl;
 				return;
@@ -99,23 +348,25 @@ void LevelImporter::StoreCharactersInitialPositions()
 void LevelImporter::StoreListForegroundTileNames()
 {
 	bool foundTiles = false;
-	const char* nodeName;
+	XmlStringView nodeName;
 
-	while (m_lvlFile && m_lvlFile->read())
+	while (m_lvlFile.Read())
 	{
-		switch (m_lvlFile->getNodeType())
+		switch (m_lvlFile.GetNodeType())
 		{
-			case EXN_ELEMENT:
+			case XML_ELEMENT:
 				foundTiles = true;
-				nodeName = m_lvlFile->getNodeName();
-				if (!strcmp("box", nodeName))
+				nodeName = m_lvlFile.GetNodeName();
+				if (nodeName.Equals("box"))
 					StoreBox();
-				if (!strcmp("pipe", nodeName))
+				if (nodeName.Equals("pipe"))
 					StorePipe();
-				if (!strcmp("floor_tile", nodeName))
+				if (nodeName.Equals("floor_tile"))
 					StoreFloor();
+				if (nodeName.Equals("tile_layer"))
+					StoreTileLayer();
 				break;
-			case EXN_ELEMENT_END:
+			case XML_ELEMENT_END:
 				if (!foundTiles)
 					std::cerr << "No foreground items in level file." << std::endl;
 				return;
@@ -133,9 +384,7 @@ void LevelImporter::StoreBox()
 
 	State tmpState = GetAttributeValue("state", true) == "empty" ? EMPTY : NORMAL;
 
-	Box *tmpBox = new Box(m_eventEngine, "item_" + tmpTileName, tmpCoords, tmpState);
-	Event newBox(tmpBox);
-	m_eventEngine->dispatch("game.new_foreground_item_read", &newBox);
+	m_level->items.push_back(m_levelArena->Create<Box>(m_eventEngine, "item_" + tmpTileName, tmpCoords, tmpState));
 }
 
 void LevelImporter::StorePipe()
@@ -149,9 +398,9 @@ void LevelImporter::StorePipe()
 
 	if (std::find(m_pipeIds.begin(), m_pipeIds.end(), id) == m_pipeIds.end())
 	{
-		Pipe *tmpPipe = new Pipe("item_" + tmpTileName, tmpCoords, id, type, m_eventEngine);
-		Event newPipe(tmpPipe);
-		m_eventEngine->dispatch("game.new_pipe_read", &newPipe);
+		Pipe *tmpPipe = m_levelArena->Create<Pipe>("item_" + tmpTileName, tmpCoords, id, type, m_eventEngine);
+		m_level->items.push_back(tmpPipe);
+		m_level->pipes.push_back(tmpPipe);
 
 		m_pipeIds.push_back(id);
 	}
@@ -177,14 +426,34 @@ void LevelImporter::StoreFloor()
 	std::string tmpTileName;
 	GetCoordinatesAndTileName(&tmpCoords, &tmpTileName);
 
-	DisplayableObject *tmpFloor = new DisplayableObject(m_eventEngine, "floor_" + tmpTileName, tmpCoords, NORMAL);
-	Event newFloor(tmpFloor);
-	m_eventEngine->dispatch("game.new_foreground_item_read", &newFloor);
+	m_tileMap->AddTile(m_tileMap->GetTypeIndex("floor_" + tmpTileName), tmpCoords);
+}
+
+/* The whole grid is decoded at once, then its tiles go straight to the TileMap */
+void LevelImporter::StoreTileLayer()
+{
+	TileLayer layer;
+	if (!layer.Read(&m_lvlFile))
+		return;
+
+	std::vector<unsigned short> typeIndexes(layer.GetTileset().size());
+	for (unsigned int i = 0; i < typeIndexes.size(); i++)
+		typeIndexes[i] = m_tileMap->GetTypeIndex(layer.GetTileset()[i]);
+
+	for (unsigned int row = 0; row < layer.GetNbRows(); row++)
+	{
+		for (unsigned int column = 0; column < layer.GetNbColumns(); column++)
+		{
+			unsigned short cell = layer.GetCell(column, row);
+			if (cell != 0)
+				m_tileMap->AddTile(typeIndexes[cell - 1], sf::Vector2f(layer.GetX() + column * TileMap::TileSize, layer.GetY() + row * TileMap::TileSize));
+		}
+	}
 }
 
 std::string LevelImporter::GetAttributeValue(const char* _name, bool _optionalAttribute)
 {
-	std::string str(m_lvlFile->getAttributeValueSafe(_name));
+	std::string str = m_lvlFile.GetAttribute(_name).ToString();
 	if (str == "" && !_optionalAttribute)
 		std::cerr << "Can't read attribute " << _name << std::endl;
 	return str;
@@ -192,7 +461,7 @@ std::string LevelImporter::GetAttributeValue(const char* _name, bool _optionalAt
 
 float LevelImporter::GetAttributeValueAsFloat(const char* _name)
 {
-	float ret = m_lvlFile->getAttributeValueAsFloat(_name);
+	float ret = m_lvlFile.GetAttributeAsFloat(_name);
 	if (ret == -1)
 		std::cerr << "Can't read attribute " << _name << std::endl;
 	return ret;
@@ -200,7 +469,7 @@ float LevelImporter::GetAttributeValueAsFloat(const char* _name)
 
 int LevelImporter::GetAttributeValueAsInt(const char* _name)
 {
-	int ret = m_lvlFile->getAttributeValueAsInt(_name);
+	int ret = m_lvlFile.GetAttributeAsInt(_name);
 	if (ret == -1)
 		std::cerr << "Can't read attribute " << _name << std::endl;
 	return ret;
@@ -2,12 +2,20 @@
 #define LEVELIMPORTER_H
 
 #include <string>
-#include "../System/irrXML/irrXML.h"
 #include "../System/Items/Pipe.hpp"
 #include "../System/Util.hpp"
 #include "../System/EventEngine/EventEngine.hpp"
+#include "../System/LevelArena.hpp"
+#include "../System/TileMap.hpp"
+#include "../System/XmlStreamReader.hpp"
+#include "LevelDescription.hpp"
+#include "LevelTemplate.hpp"
 
 class GameEngine;
+struct CompiledLevelHeader;
+struct CompiledObject;
+struct CompiledPipe;
+struct PreparedLevel;
 
 /*
  * LevelImporter: All operations dealing with the XML file representing a level
@@ -16,19 +24,28 @@ class GameEngine;
 class LevelImporter
 {
 	public:
-		LevelImporter(EventEngine *_eventEngine);
-
-		bool LoadLevel(std::string _lvlName);
+		LevelImporter(EventEngine *_eventEngine, LevelArena *_levelArena, TileMap *_tileMap);
+
+		/* The objects of the level are created and put in _level, for GameEngine to register them all at once. The floor goes straight to the TileMap */
+		bool LoadLevel(std::string _lvlName, LevelDescription& _level);
+		bool LoadCompiledLevel(std::string _lvlName, LevelDescription& _level); // False if there is no compiled file for the level or it's out of date: nothing was loaded
+		void LoadPreparedLevel(PreparedLevel& _prepared, LevelDescription& _level); // Its tiles are moved to the TileMap
+		bool ReloadLevel(const std::string& _lvlName, LevelTemplate& _template, LevelChanges& _changes); // The file changed since the level was loaded: only the differences are created or listed. False if it can't be read
+		static std::string GetFileName(const std::string& _lvlName);
 		void StoreCharactersInitialPositions();
 		void StoreListForegroundTileNames();
 		void StoreBox();
 		void StorePipe();
 		PipeType GetPipeTypeFromXML();
 		void StoreFloor();
+		void StoreTileLayer();
 
 	private:
 		EventEngine *m_eventEngine;
-		irr::io::IrrXMLReader *m_lvlFile;
+		LevelArena *m_levelArena; // Where the level items are created (not the characters: they can die before the end of the level)
+		TileMap *m_tileMap; // Where the floor goes
+		XmlStreamReader m_lvlFile;
+		LevelDescription *m_level; // Only while loading
 
 		std::vector<int> m_pipeIds; // This is used to check that no 2 pipes have the same ID
 
@@ -36,6 +53,9 @@ class LevelImporter
 		float GetAttributeValueAsFloat(const char* _name);
 		int GetAttributeValueAsInt(const char* _name);
 		void GetCoordinatesAndTileName(sf::Vector2f *_coords, std::string *_tileName);
+		void CreateCompiledObjects(const CompiledLevelHeader& _header, const char* _data, LevelDescription& _level);
+		void CreateCompiledObject(const CompiledObject& _object, LevelDescription& _level);
+		void CreateCompiledPipe(const CompiledPipe& _pipe, LevelDescription& _level);
 
 		static const std::string levelsPath;
 };
@@ -0,0 +1,144 @@
+#include "LevelPrefetcher.hpp"
+#include "LevelCompiler.hpp"
+#include "LevelImporter.hpp"
+#include "../System/MappedFile.hpp"
+
+LevelPrefetcher::LevelPrefetcher() : m_stopWorker(false), m_useCompiledLevel(true), m_writeCompiledLevel(false), m_request(0), m_pending(false), m_ready(false), m_level(NULL)
+{
+}
+
+LevelPrefetcher::~LevelPrefetcher()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stopWorker = true;
+	}
+	m_levelRequested.notify_one();
+	if (m_worker.joinable())
+		m_worker.join();
+	delete m_level;
+}
+
+void LevelPrefetcher::Prefetch(const std::string& _lvlName, bool _useCompiledLevel, bool _writeCompiledLevel)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (_lvlName == m_lvlName && _useCompiledLevel == m_useCompiledLevel && _writeCompiledLevel == m_writeCompiledLevel)
+			return;
+
+		delete m_level;
+		m_level = NULL;
+		m_ready = false;
+		m_lvlName = _lvlName;
+		m_useCompiledLevel = _useCompiledLevel;
+		m_writeCompiledLevel = _writeCompiledLevel;
+		m_request++;
+		m_pending = true;
+	}
+
+	if (!m_worker.joinable())
+		m_worker = std::thread(&LevelPrefetcher::PrepareRequestedLevels, this);
+	m_levelRequested.notify_one();
+}
+
+void LevelPrefetcher::Cancel()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	delete m_level;
+	m_level = NULL;
+	m_ready = false;
+	m_lvlName.clear();
+	m_request++;
+	m_pending = false;
+}
+
+PreparedLevel* LevelPrefetcher::Take(const std::string& _lvlName)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	if (m_lvlName.empty() || _lvlName != m_lvlName)
+		return NULL;
+
+	m_levelPrepared.wait(lock, [this] { return m_ready; });
+	PreparedLevel* level = m_level;
+	m_level = NULL;
+	m_ready = false;
+	m_lvlName.clear();
+	return level;
+}
+
+/* Worker thread: only the level it's given is touched from here, g isn't */
+void LevelPrefetcher::PrepareRequestedLevels()
+{
+	while (true)
+	{
+		std::string lvlName;
+		bool useCompiledLevel;
+		bool writeCompiledLevel;
+		unsigned int request;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_levelRequested.wait(lock, [this] { return m_stopWorker || m_pending; });
+			if (m_stopWorker)
+				return;
+			lvlName = m_lvlName;
+			useCompiledLevel = m_useCompiledLevel;
+			writeCompiledLevel = m_writeCompiledLevel;
+			request = m_request;
+			m_pending = false;
+		}
+
+		PreparedLevel* level = Prepare(lvlName, useCompiledLevel, writeCompiledLevel);
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (request == m_request)
+			{
+				m_level = level;
+				m_ready = true;
+				level = NULL;
+			}
+		}
+		delete level; // Another level was requested in the meantime
+		m_levelPrepared.notify_all();
+	}
+}
+
+/* The compiled file if it's up to date, or the XML file compiled now, and written for the next time only if it's asked (--write-compiled-levels): playing doesn't touch the levels otherwise */
+PreparedLevel* LevelPrefetcher::Prepare(const std::string& _lvlName, bool _useCompiledLevel, bool _writeCompiledLevel)
+{
+	sf::Clock clock;
+	PreparedLevel* level = new PreparedLevel();
+	level->name = _lvlName;
+
+	bool upToDate = false;
+	MappedFile file;
+	if (_useCompiledLevel && file.Open(LevelCompiler::GetFileName(_lvlName)))
+	{
+		const CompiledLevelHeader* header = LevelCompiler::GetHeader(file.GetData(), file.GetSize());
+		upToDate = header != NULL && LevelCompiler::IsUpToDate(*header, LevelImporter::GetFileName(_lvlName));
+		if (upToDate)
+			level->data.assign(file.GetData(), file.GetData() + file.GetSize());
+	}
+	file.Close();
+
+	if (!upToDate)
+	{
+		if (!LevelCompiler::Build(_lvlName, level->data))
+		{
+			delete level;
+			return NULL;
+		}
+		if (_writeCompiledLevel)
+			LevelCompiler::Write(_lvlName, level->data);
+	}
+
+	// The types of the tiles are the indexes in the table of the file, they're created in the same order by LevelImporter::LoadPreparedLevel
+	const CompiledLevelHeader* header = (const CompiledLevelHeader*)&level->data[0];
+	std::vector<unsigned short> typeIndexes(header->nbTileTypes);
+	for (unsigned int i = 0; i < typeIndexes.size(); i++)
+		typeIndexes[i] = (unsigned short)i;
+	level->tiles.LoadGrid((const unsigned short*)(&level->data[0] + header->gridOffset), header->nbColumns, header->nbRows, typeIndexes);
+
+	level->preparationTime = clock.getElapsedTime().asSeconds() * 1000;
+	return level;
+}
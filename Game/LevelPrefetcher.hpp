@@ -0,0 +1,53 @@
+#ifndef LEVELPREFETCHER_H
+#define LEVELPREFETCHER_H
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../System/TileMap.hpp"
+
+/* A level read by LevelPrefetcher: all that's left is to create its objects, which only the game thread can do (their ids, SpriteRegistry) */
+struct PreparedLevel
+{
+	std::string name;
+	std::vector<char> data;	// The compiled level (see LevelCompiler), read from its file or compiled from the XML file
+	TileMap tiles;			// The grid of data, already compressed. Its types aren't created
+	float preparationTime;	// In ms, on the worker thread
+};
+
+/*
+*	The next level is read (compiled first if it's not, or not anymore), and its tiles compressed, by a worker thread while the current one is played:
+*	starting it is then only creating its objects (see GameEngine::StartLevel)
+*/
+class LevelPrefetcher
+{
+	public:
+		LevelPrefetcher();
+		~LevelPrefetcher();
+
+		void Prefetch(const std::string& _lvlName, bool _useCompiledLevel, bool _writeCompiledLevel); // Replaces the level prefetched before
+		void Cancel();
+		PreparedLevel* Take(const std::string& _lvlName); // Waits for the level if it's not ready. NULL if it's not the one prefetched or it can't be read. To delete
+
+	private:
+		std::thread m_worker; // Started by the first request
+		std::mutex m_mutex; // Everything below
+		std::condition_variable m_levelRequested;
+		std::condition_variable m_levelPrepared;
+		bool m_stopWorker;
+
+		std::string m_lvlName; // Empty if nothing is prefetched
+		bool m_useCompiledLevel;
+		bool m_writeCompiledLevel;
+		unsigned int m_request; // Incremented by each request: a level prepared for a request that was replaced is thrown away
+		bool m_pending; // Not taken by the worker yet
+		bool m_ready;
+		PreparedLevel* m_level; // Once it's ready. NULL if it couldn't be read
+
+		void PrepareRequestedLevels(); // Worker thread
+		static PreparedLevel* Prepare(const std::string& _lvlName, bool _useCompiledLevel, bool _writeCompiledLevel);
+};
+
+#endif
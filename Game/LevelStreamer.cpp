@@ -0,0 +1,473 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include "LevelStreamer.hpp"
+#include "TileLayer.hpp"
+
+const float LevelStreamer::LoadBehind = 1.f * LevelStreamer::SectionWidth;
+const float LevelStreamer::LoadAhead = 2.f * LevelStreamer::SectionWidth;
+const float LevelStreamer::ViewBehind = 0.5f * LevelStreamer::SectionWidth;
+const float LevelStreamer::ViewAhead = 1.f * LevelStreamer::SectionWidth;
+const float LevelStreamer::EvictBehind = 3.f * LevelStreamer::SectionWidth; // Farther than the loading distance, so a section at the limit isn't loaded and evicted every frame
+const float LevelStreamer::EvictAhead = 4.f * LevelStreamer::SectionWidth;
+
+LevelStreamer::LevelStreamer() : m_stopLoader(false), m_inTileLayer(false)
+{
+}
+
+LevelStreamer::~LevelStreamer()
+{
+	Close();
+}
+
+/*	One pass over the file, by blocks: each tag of an element of the level is located (offset and length) and filed in the section of its x coordinate,
+	the grid of each tile layer is cut in spans, filed in the section of their first column.
+	Only the <level> and <mario> tags are read now, the rest is read by the loading thread when its section is requested */
+bool LevelStreamer::Open(const std::string& _fileName, LevelInfo& _info, sf::Vector2f& _marioPosition)
+{
+	Close();
+
+	std::ifstream file(_fileName.c_str(), std::ios::binary);
+	if (!file)
+	{
+		std::cerr << "Can't read level file " << _fileName << std::endl;
+		return false;
+	}
+	m_fileName = _fileName;
+	m_inTileLayer = false;
+
+	const unsigned int blockSize = 64 * 1024;
+	std::vector<char> block(blockSize);
+	std::string tag;
+	unsigned int tagOffset = 0;
+	unsigned int blockOffset = 0;
+	bool inTag = false;
+
+	while (file)
+	{
+		file.read(&block[0], blockSize);
+		std::streamsize nbRead = file.gcount();
+		for (std::streamsize i = 0; i < nbRead; i++)
+		{
+			char c = block[(unsigned int)i];
+			if (!inTag)
+			{
+				if (c == '<')
+				{
+					inTag = true;
+					tag.assign(1, c);
+					tagOffset = blockOffset + (unsigned int)i;
+				}
+				else if (m_inTileLayer)
+					m_tileLayerIndexer.Feed(c, blockOffset + (unsigned int)i);
+			}
+			else
+			{
+				tag += c;
+				if (c == '>')
+				{
+					inTag = false;
+					AddToIndex(tag, tagOffset, _info, _marioPosition);
+				}
+			}
+		}
+		blockOffset += (unsigned int)nbRead;
+	}
+
+	m_stopLoader = false;
+	m_loader = std::thread(&LevelStreamer::LoadRequestedSections, this);
+	return true;
+}
+
+void LevelStreamer::Close()
+{
+	if (m_loader.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stopLoader = true;
+		}
+		m_sectionRequested.notify_all();
+		m_loader.join();
+	}
+
+	for (unsigned int i = 0; i < m_sections.size(); i++)
+		delete m_sections[i]; // Their objects were removed from g by GameEngine::UnloadLevel
+	m_sections.clear();
+	m_requests.clear();
+	m_tileLayers.clear();
+	m_inTileLayer = false;
+}
+
+void LevelStreamer::AddToIndex(const std::string& _tag, unsigned int _offset, LevelInfo& _info, sf::Vector2f& _marioPosition)
+{
+	if (m_inTileLayer && _tag.compare(0, 13, "</tile_layer>") == 0)
+	{
+		m_inTileLayer = false;
+		const StreamedTileLayer& layer = m_tileLayers.back();
+		std::vector<TileLayerSpan> spans;
+		if (!m_tileLayerIndexer.End(spans))
+		{
+			std::cerr << "Can't read tile layer at " << layer.x << ", " << layer.y << ". No tile created." << std::endl;
+			return;
+		}
+		for (unsigned int i = 0; i < spans.size(); i++)
+			GetSection(layer.x + spans[i].firstColumn * TileMap::TileSize)->tileSpans.push_back(spans[i]);
+		return;
+	}
+
+	if (_tag.size() < 2 || _tag[1] == '/' || _tag[1] == '?' || _tag[1] == '!')
+		return;
+
+	if (_tag.compare(0, 12, "<tile_layer ") == 0 && _tag[_tag.size() - 2] != '/') // Its grid is the text up to </tile_layer>
+	{
+		std::string value, tileset, encoding;
+		StreamedTileLayer layer;
+		layer.x = GetAttribute(_tag, "x", value) ? (float)atof(value.c_str()) : 0;
+		layer.y = GetAttribute(_tag, "y", value) ? (float)atof(value.c_str()) : 0;
+		GetAttribute(_tag, "tileset", tileset);
+		GetAttribute(_tag, "encoding", encoding);
+		layer.tileset = TileLayer::GetSpriteNames(tileset);
+		layer.base64 = encoding == "base64";
+		int nbColumns = (int)GetAttributeAsFloat(_tag, "columns");
+		int nbRows = (int)GetAttributeAsFloat(_tag, "rows");
+		if ((encoding != "rle" && !layer.base64) || !TileLayer::IsSizeValid(nbColumns, nbRows) || layer.x < 0 || layer.y < 0)
+		{
+			std::cerr << "Can't read tile layer at " << layer.x << ", " << layer.y << ". No tile created." << std::endl;
+			return;
+		}
+
+		// A row is cut where a section starts
+		std::vector<unsigned int> cuts(1, 0);
+		for (unsigned int section = (unsigned int)layer.x / SectionWidth + 1; ; section++)
+		{
+			unsigned int column = (unsigned int)ceil((section * SectionWidth - layer.x) / TileMap::TileSize);
+			if (column >= (unsigned int)nbColumns)
+				break;
+			if (column > cuts.back())
+				cuts.push_back(column);
+		}
+
+		m_inTileLayer = true;
+		m_tileLayers.push_back(layer);
+		m_tileLayerIndexer.Begin(m_tileLayers.size() - 1, (unsigned int)nbColumns, (unsigned int)nbRows, layer.base64, cuts);
+		return;
+	}
+
+	if (_tag.compare(0, 7, "<level ") == 0)
+	{
+		GetAttribute(_tag, "background", _info.backgroundName);
+		_info.size.x = GetAttributeAsFloat(_tag, "width");
+		_info.size.y = GetAttributeAsFloat(_tag, "height");
+
+		unsigned int nbSections = (unsigned int)(_info.size.x + SectionWidth - 1) / SectionWidth;
+		while (m_sections.size() < nbSections)
+		{
+			LevelSection* section = new LevelSection();
+			section->index = m_sections.size();
+			section->status = SECTION_EVICTED;
+			m_sections.push_back(section);
+		}
+		return;
+	}
+
+	if (_tag.compare(0, 7, "<mario ") == 0)
+	{
+		_marioPosition.x = GetAttributeAsFloat(_tag, "x");
+		_marioPosition.y = GetAttributeAsFloat(_tag, "y");
+		return;
+	}
+
+	if (_tag.compare(0, 8, "<goomba ") != 0 && _tag.compare(0, 5, "<box ") != 0 && _tag.compare(0, 6, "<pipe ") != 0 && _tag.compare(0, 12, "<floor_tile ") != 0)
+		return;
+
+	float x = GetAttributeAsFloat(_tag, "x");
+	AddRangeToSections(_offset, _tag.size(), x, x);
+}
+
+/* The range goes in each section from the one of _left to the one of _right */
+void LevelStreamer::AddRangeToSections(unsigned int _offset, unsigned int _length, float _left, float _right)
+{
+	unsigned int firstSection = GetSection(_left)->index;
+	unsigned int lastSection = GetSection(_right)->index;
+	for (unsigned int i = firstSection; i <= lastSection; i++)
+		m_sections[i]->ranges.push_back(std::make_pair(_offset, _length));
+}
+
+LevelSection* LevelStreamer::GetSection(float _x)
+{
+	unsigned int index = _x > 0 ? (unsigned int)_x / SectionWidth : 0;
+	while (m_sections.size() <= index) // Element out of the level
+	{
+		LevelSection* section = new LevelSection();
+		section->index = m_sections.size();
+		section->status = SECTION_EVICTED;
+		m_sections.push_back(section);
+	}
+	return m_sections[index];
+}
+
+void LevelStreamer::Update(float _focusX)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	bool newRequests = false;
+	for (unsigned int i = 0; i < m_sections.size(); i++)
+	{
+		float left = (float)(i * SectionWidth);
+		if (m_sections[i]->status == SECTION_EVICTED && left + SectionWidth > _focusX - LoadBehind && left < _focusX + LoadAhead)
+		{
+			m_sections[i]->status = SECTION_REQUESTED;
+			m_requests.push_back(m_sections[i]);
+			newRequests = true;
+		}
+	}
+	if (newRequests)
+		m_sectionRequested.notify_one();
+
+	// A section in view can't be late
+	for (unsigned int i = 0; i < m_sections.size(); i++)
+	{
+		float left = (float)(i * SectionWidth);
+		if (left + SectionWidth > _focusX - ViewBehind && left < _focusX + ViewAhead)
+		{
+			LevelSection* section = m_sections[i];
+			m_sectionLoaded.wait(lock, [section] { return section->status != SECTION_REQUESTED; });
+		}
+	}
+}
+
+LevelSection* LevelStreamer::PopReadySection()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	for (unsigned int i = 0; i < m_sections.size(); i++)
+	{
+		if (m_sections[i]->status == SECTION_READY)
+		{
+			m_sections[i]->status = SECTION_LOADED;
+			return m_sections[i];
+		}
+	}
+	return NULL;
+}
+
+LevelSection* LevelStreamer::PopSectionToEvict(float _focusX)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	for (unsigned int i = 0; i < m_sections.size(); i++)
+	{
+		float left = (float)(i * SectionWidth);
+		if (m_sections[i]->status == SECTION_LOADED && (left + SectionWidth <= _focusX - EvictBehind || left >= _focusX + EvictAhead))
+		{
+			m_sections[i]->status = SECTION_EVICTED;
+			return m_sections[i];
+		}
+	}
+	return NULL;
+}
+
+unsigned int LevelStreamer::GetNbLoadedSections() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	unsigned int nbLoaded = 0;
+	for (unsigned int i = 0; i < m_sections.size(); i++)
+	{
+		if (m_sections[i]->status == SECTION_LOADED)
+			nbLoaded++;
+	}
+	return nbLoaded;
+}
+
+LevelSection* LevelStreamer::GetNearestLoadedSection(float _x)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (m_sections.empty())
+		return NULL;
+	int index = _x > 0 ? (int)std::min((unsigned int)_x / SectionWidth, (unsigned int)m_sections.size() - 1) : 0;
+	for (int distance = 0; distance < (int)m_sections.size(); distance++)
+	{
+		if (index - distance >= 0 && m_sections[index - distance]->status == SECTION_LOADED)
+			return m_sections[index - distance];
+		if (index + distance < (int)m_sections.size() && m_sections[index + distance]->status == SECTION_LOADED)
+			return m_sections[index + distance];
+	}
+	return NULL;
+}
+
+/* Loading thread: reads the requested sections, in the order they were requested. Nothing in g is touched from here */
+void LevelStreamer::LoadRequestedSections()
+{
+	std::ifstream file(m_fileName.c_str(), std::ios::binary);
+
+	while (true)
+	{
+		LevelSection* section = NULL;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_sectionRequested.wait(lock, [this] { return m_stopLoader || !m_requests.empty(); });
+			if (m_stopLoader)
+				return;
+			section = m_requests.front();
+			m_requests.pop_front();
+		}
+
+		ReadSection(file, *section); // The ranges don't change once the file is indexed, and the elements aren't read by anyone else until the section is ready
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			section->status = SECTION_READY;
+		}
+		m_sectionLoaded.notify_all();
+	}
+}
+
+void LevelStreamer::ReadSection(std::ifstream& _file, LevelSection& _section)
+{
+	std::string tag;
+	_section.elements.clear();
+	_section.elements.reserve(_section.ranges.size() + _section.tileSpans.size() * TileMap::ChunkSize);
+
+	for (unsigned int i = 0; i < _section.ranges.size(); i++)
+	{
+		tag.resize(_section.ranges[i].second);
+		_file.clear();
+		_file.seekg(_section.ranges[i].first);
+		_file.read(&tag[0], tag.size());
+
+		LevelElement element;
+		if (ParseElement(tag, element))
+			_section.elements.push_back(element);
+		else
+			std::cerr << "Can't read level element at offset " << _section.ranges[i].first << " in " << m_fileName << std::endl;
+	}
+
+	for (unsigned int i = 0; i < _section.tileSpans.size(); i++)
+		ReadTileSpan(_file, _section.tileSpans[i], _section);
+}
+
+/* Only the characters of the span are read, its tiles are in the section: they start in it, and a span is at most as wide as it */
+void LevelStreamer::ReadTileSpan(std::ifstream& _file, const TileLayerSpan& _span, LevelSection& _section)
+{
+	const StreamedTileLayer& layer = m_tileLayers[_span.layer];
+	std::string data(_span.length, '\0');
+	_file.clear();
+	_file.seekg(_span.offset);
+	_file.read(&data[0], data.size());
+
+	std::vector<unsigned short> cells;
+	if (!TileLayer::DecodeSpan(_span, layer.base64, data.c_str(), cells))
+	{
+		std::cerr << "Can't read tile layer at " << layer.x << ", " << layer.y << ", row " << _span.row << ". No tile created." << std::endl;
+		return;
+	}
+
+	LevelElement element;
+	element.kind = FLOOR_ELEMENT;
+	element.state = NORMAL;
+	element.direction = DRIGHT;
+	element.pipeType = TRAVEL;
+	element.pipeId = -1;
+	element.position.y = layer.y + _span.row * TileMap::TileSize;
+	for (unsigned int i = 0; i < cells.size(); i++)
+	{
+		if (cells[i] == 0 || cells[i] > layer.tileset.size())
+			continue;
+		element.position.x = layer.x + (_span.firstColumn + i) * TileMap::TileSize;
+		element.sprite = layer.tileset[cells[i] - 1];
+		_section.elements.push_back(element);
+	}
+}
+
+bool LevelStreamer::ParseElement(const std::string& _tag, LevelElement& _element)
+{
+	std::string value;
+
+	_element.position.x = GetAttributeAsFloat(_tag, "x");
+	_element.position.y = GetAttributeAsFloat(_tag, "y");
+	_element.state = NORMAL;
+	_element.direction = DRIGHT;
+	_element.pipeType = TRAVEL;
+	_element.pipeId = -1;
+
+	if (_tag.compare(0, 7, "<mario ") == 0)
+	{
+		_element.kind = MARIO_ELEMENT;
+		_element.sprite = "mario";
+	}
+	else if (_tag.compare(0, 8, "<goomba ") == 0)
+	{
+		_element.kind = GOOMBA_ELEMENT;
+		_element.sprite = "goomba";
+		if (GetAttribute(_tag, "direction", value) && value == "left")
+			_element.direction = DLEFT;
+	}
+	else if (_tag.compare(0, 5, "<box ") == 0)
+	{
+		_element.kind = BOX_ELEMENT;
+		if (!GetAttribute(_tag, "sprite", value))
+			return false;
+		_element.sprite = "item_" + value;
+		if (GetAttribute(_tag, "state", value) && value == "empty")
+			_element.state = EMPTY;
+	}
+	else if (_tag.compare(0, 6, "<pipe ") == 0)
+	{
+		_element.kind = PIPE_ELEMENT;
+		if (!GetAttribute(_tag, "sprite", value))
+			return false;
+		_element.sprite = "item_" + value;
+		if (!GetAttribute(_tag, "type", value))
+			return false;
+		_element.pipeType = value == "spawn" ? SPAWN : value == "flower" ? FLOWER : TRAVEL;
+		if (!GetAttribute(_tag, "id", value))
+			return false;
+		_element.pipeId = atoi(value.c_str());
+	}
+	else if (_tag.compare(0, 12, "<floor_tile ") == 0)
+	{
+		_element.kind = FLOOR_ELEMENT;
+		if (!GetAttribute(_tag, "sprite", value))
+			return false;
+		_element.sprite = "floor_" + value;
+	}
+	else
+		return false;
+
+	return true;
+}
+
+/* Value of the attribute _name in the tag. The tags of the level files are simple enough: no entity, no quote inside a value */
+bool LevelStreamer::GetAttribute(const std::string& _tag, const char* _name, std::string& _value)
+{
+	size_t nameLength = strlen(_name);
+	size_t pos = 0;
+	while ((pos = _tag.find(_name, pos + 1)) != std::string::npos)
+	{
+		bool startsName = isspace((unsigned char)_tag[pos - 1]) != 0;
+		size_t equal = pos + nameLength;
+		if (startsName && equal + 1 < _tag.size() && _tag[equal] == '=' && (_tag[equal + 1] == '"' || _tag[equal + 1] == '\''))
+		{
+			size_t end = _tag.find(_tag[equal + 1], equal + 2);
+			if (end == std::string::npos)
+				return false;
+			_value.assign(_tag, equal + 2, end - equal - 2);
+			return true;
+		}
+	}
+	return false;
+}
+
+float LevelStreamer::GetAttributeAsFloat(const std::string& _tag, const char* _name)
+{
+	std::string value;
+	if (!GetAttribute(_tag, _name, value))
+	{
+		std::cerr << "Can't read attribute " << _name << std::endl;
+		return -1; // As irrXML
+	}
+	return (float)atof(value.c_str());
+}
@@ -0,0 +1,136 @@
+#ifndef LEVELSTREAMER_H
+#define LEVELSTREAMER_H
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../System/LevelArena.hpp"
+#include "../System/TileMap.hpp"
+#include "../System/Util.hpp"
+#include "TileLayer.hpp"
+
+class DisplayableObject;
+class Pipe;
+
+enum LevelElementKind
+{
+	MARIO_ELEMENT,
+	GOOMBA_ELEMENT,
+	BOX_ELEMENT,
+	PIPE_ELEMENT,
+	FLOOR_ELEMENT
+};
+
+/* One element of the foreground or the characters of a level file, as it's written in it */
+struct LevelElement
+{
+	LevelElementKind kind;
+	std::string sprite;
+	sf::Vector2f position;
+	State state;		// Box
+	Direction direction;// Goomba
+	PipeType pipeType;	// Pipe
+	int pipeId;			// Pipe
+};
+
+enum SectionStatus
+{
+	SECTION_EVICTED,	// Nothing in memory but where to find it in the file
+	SECTION_REQUESTED,	// Waiting for the loading thread
+	SECTION_READY,		// Read by the loading thread, its objects are not created yet
+	SECTION_LOADED		// Its objects are in g
+};
+
+/*
+*	A vertical slice of the level, as wide as a column of chunks of the TileMap
+*	Its items live in its own arena, so that the section can go without touching the rest of the level
+*/
+struct LevelSection
+{
+	unsigned int index;
+	SectionStatus status;
+	std::vector<std::pair<unsigned int, unsigned int> > ranges; // Offset and length of each of its elements in the file
+	std::vector<TileLayerSpan> tileSpans; // Its part of each row of the tile layers it's in
+
+	std::vector<LevelElement> elements; // Filled by the loading thread, emptied once the objects are created
+
+	LevelArena arena;
+	std::vector<std::pair<unsigned int, DisplayableObject*> > items; // Index of the element, item created from it
+	std::vector<Pipe*> pipes;
+	std::vector<unsigned int> characters; // Ids of the characters created from its elements, in the order they were: sorted. They go with it wherever they are
+	std::map<unsigned int, State> savedStates; // Index of the element -> state when the section was evicted (emptied boxes...)
+};
+
+/*
+*	Streaming mode of the levels: instead of creating everything at the start, the level file is indexed by section in one pass,
+*	and the sections are read by a background thread as Mario gets close to them. The sections far behind are evicted (see GameEngine)
+*	Only the index and the sections around Mario are in memory, whatever the length of the level
+*/
+class LevelStreamer
+{
+	public:
+		static const unsigned int SectionWidth = TileMap::ChunkSize * TileMap::TileSize; // In pixels
+
+		LevelStreamer();
+		~LevelStreamer();
+
+		bool Open(const std::string& _fileName, LevelInfo& _info, sf::Vector2f& _marioPosition); // Indexes the file, no section is loaded
+		void Close(); // Every section goes, loaded or not
+
+		void Update(float _focusX); // Asks for the sections around _focusX, and waits for the ones that will be in view
+		LevelSection* PopReadySection(); // A section whose objects have to be created: it's marked as loaded
+		LevelSection* PopSectionToEvict(float _focusX); // A loaded section that is too far: it's marked as evicted
+
+		unsigned int GetNbLoadedSections() const;
+		LevelSection* GetNearestLoadedSection(float _x); // The one _x is in if it's loaded, the closest loaded one otherwise. NULL if none is
+
+		static bool ParseElement(const std::string& _tag, LevelElement& _element); // _tag is the whole tag, from < to >
+
+	private:
+		std::string m_fileName;
+		std::vector<LevelSection*> m_sections;
+
+		std::thread m_loader;
+		mutable std::mutex m_mutex; // Status of the sections, their elements and m_requests
+		std::condition_variable m_sectionRequested;
+		std::condition_variable m_sectionLoaded;
+		std::deque<LevelSection*> m_requests;
+		bool m_stopLoader;
+
+		void LoadRequestedSections(); // Loading thread
+		void ReadSection(std::ifstream& _file, LevelSection& _section);
+		void AddToIndex(const std::string& _tag, unsigned int _offset, LevelInfo& _info, sf::Vector2f& _marioPosition);
+		void AddRangeToSections(unsigned int _offset, unsigned int _length, float _left, float _right);
+		LevelSection* GetSection(float _x); // Created if it's out of the level
+		void ReadTileSpan(std::ifstream& _file, const TileLayerSpan& _span, LevelSection& _section);
+
+		/* What a span needs from the tag of its <tile_layer> */
+		struct StreamedTileLayer
+		{
+			float x;
+			float y;
+			std::vector<std::string> tileset;
+			bool base64;
+		};
+
+		/* Each <tile_layer> is cut in spans while it's indexed: a section only reads its columns of it */
+		std::vector<StreamedTileLayer> m_tileLayers;
+		TileLayerIndexer m_tileLayerIndexer;
+		bool m_inTileLayer;
+
+		static bool GetAttribute(const std::string& _tag, const char* _name, std::string& _value);
+		static float GetAttributeAsFloat(const std::string& _tag, const char* _name);
+
+		static const float LoadBehind; // Sections closer than this to the focus are requested
+		static const float LoadAhead;
+		static const float ViewBehind; // Sections closer than this to the focus are waited for
+		static const float ViewAhead;
+		static const float EvictBehind; // Sections farther than this from the focus are evicted
+		static const float EvictAhead;
+};
+
+#endif
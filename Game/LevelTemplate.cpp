@@ -0,0 +1,116 @@
+#include <algorithm>
+#include "LevelTemplate.hpp"
+#include "../System/Characters/Goomba.hpp"
+#include "../System/Characters/Player.hpp"
+
+void LevelTemplate::Record(const LevelInfo& _info, const LevelDescription& _level)
+{
+	Clear();
+	m_info = _info;
+	Add(_level);
+}
+
+void LevelTemplate::Clear()
+{
+	m_characters.clear();
+	m_items.clear();
+	m_modifiedItems.clear();
+}
+
+/* The ids are given in the order the objects are created: the new items go after the others, m_items stays sorted */
+void LevelTemplate::Add(const LevelDescription& _level)
+{
+	m_characters.reserve(m_characters.size() + _level.characters.size());
+	for (unsigned int i = 0; i < _level.characters.size(); i++)
+	{
+		TemplateCharacter character;
+		character.id = _level.characters[i]->GetID();
+		character.spriteId = _level.characters[i]->GetSpriteId();
+		character.name = _level.characters[i]->GetName();
+		character.position = _level.characters[i]->GetPosition();
+		character.direction = _level.characters[i]->GetFacing();
+		m_characters.push_back(character);
+	}
+
+	unsigned int firstNewItem = m_items.size();
+	m_items.reserve(m_items.size() + _level.items.size());
+	for (unsigned int i = 0; i < _level.items.size(); i++)
+	{
+		TemplateItem item;
+		item.id = _level.items[i]->GetID();
+		item.spriteId = _level.items[i]->GetSpriteId();
+		item.item = _level.items[i];
+		item.pipe = NULL;
+		item.state = _level.items[i]->GetState();
+		item.modified = false;
+		item.alwaysModified = false;
+		m_items.push_back(item);
+	}
+	std::sort(m_items.begin() + firstNewItem, m_items.end());
+	assert(firstNewItem == 0 || firstNewItem == m_items.size() || m_items[firstNewItem - 1].id < m_items[firstNewItem].id);
+
+	for (unsigned int i = 0; i < _level.pipes.size(); i++)
+	{
+		TemplateItem key;
+		key.id = _level.pipes[i]->GetID();
+		std::vector<TemplateItem>::iterator item = std::lower_bound(m_items.begin() + firstNewItem, m_items.end(), key);
+		assert(item != m_items.end() && item->id == key.id); // The pipes are also in the items
+		item->pipe = _level.pipes[i];
+		if (_level.pipes[i]->GetPipeType() == SPAWN)
+		{
+			item->alwaysModified = true;
+			MarkModified(*item->item);
+		}
+	}
+}
+
+void LevelTemplate::Remove(const std::vector<bool>& _removedCharacters, const std::vector<bool>& _removedItems)
+{
+	unsigned int nbCharacters = 0;
+	for (unsigned int i = 0; i < m_characters.size(); i++)
+	{
+		if (!_removedCharacters[i])
+			m_characters[nbCharacters++] = m_characters[i];
+	}
+	m_characters.resize(nbCharacters);
+
+	// The indexes of the marked items move with them
+	unsigned int nbItems = 0;
+	m_modifiedItems.clear();
+	for (unsigned int i = 0; i < m_items.size(); i++)
+	{
+		if (_removedItems[i])
+			continue;
+		if (m_items[i].modified)
+			m_modifiedItems.push_back(nbItems);
+		m_items[nbItems++] = m_items[i];
+	}
+	m_items.resize(nbItems);
+}
+
+void LevelTemplate::MarkModified(const DisplayableObject& _item)
+{
+	TemplateItem key;
+	key.id = _item.GetID();
+	std::vector<TemplateItem>::iterator item = std::lower_bound(m_items.begin(), m_items.end(), key);
+	if (item == m_items.end() || item->id != key.id || item->modified)
+		return;
+
+	item->modified = true;
+	m_modifiedItems.push_back(item - m_items.begin());
+}
+
+/* In the order they were loaded in */
+void LevelTemplate::CreateCharacters(EventEngine *_eventEngine, LevelDescription& _level)
+{
+	_level.characters.reserve(_level.characters.size() + m_characters.size());
+	for (unsigned int i = 0; i < m_characters.size(); i++)
+	{
+		TemplateCharacter& character = m_characters[i];
+		if (character.name == "mario")
+			_level.characters.push_back(new Player(_eventEngine, character.name, character.position));
+		else
+			_level.characters.push_back(new Goomba(_eventEngine, character.name, character.position, character.direction));
+		character.id = _level.characters.back()->GetID();
+	}
+}
@@ -0,0 +1,99 @@
+#ifndef LEVELTEMPLATE_H
+#define LEVELTEMPLATE_H
+
+#include <vector>
+#include "../System/Util.hpp"
+#include "LevelDescription.hpp"
+
+/* What a new version of the level file changed (see LevelImporter::ReloadLevel), for GameEngine to apply it to the running level */
+struct LevelChanges
+{
+	LevelDescription added;
+	std::vector<unsigned int> removedCharacters;	// Ids of the characters created from the removed elements: the ones still there go
+	std::vector<DisplayableObject*> removedItems;	// They stay in the level arena until the level is unloaded
+	std::vector<Pipe*> removedPipes;				// Also in removedItems
+	std::vector<std::pair<DisplayableObject*, State> > changedItems; // Boxes whose state changed in the file
+	bool levelInfoChanged;
+	bool marioMoved;
+	sf::Vector2f initPosMario;
+	unsigned int nbChangedTileColumns;				// Of chunks, already encoded again in the TileMap
+
+	LevelChanges() : levelInfoChanged(false), marioMoved(false), nbChangedTileColumns(0) {};
+	unsigned int GetNbObjectChanges() const { return added.characters.size() + added.items.size() + removedCharacters.size() + removedItems.size() + changedItems.size(); };
+};
+
+/*
+*	The level as it was loaded, recorded once before its objects are registered: restarting it (see GameEngine::RestartLevel) doesn't read anything again.
+*	The characters are created again, the items are kept and only the ones the player changed are put back (copy on write)
+*	Only a new version of the level file changes it, element by element (see LevelImporter::ReloadLevel)
+*	The tiles aren't in it: nothing changes them during a level, the TileMap is compared with the file itself
+*/
+class LevelTemplate
+{
+	public:
+		struct TemplateCharacter
+		{
+			unsigned int id; // Of the character created from it last: it can be dead
+			unsigned int spriteId;
+			std::string name;
+			sf::Vector2f position;
+			Direction direction; // Not used for Mario
+		};
+
+		struct TemplateItem
+		{
+			unsigned int id;
+			unsigned int spriteId;
+			DisplayableObject *item; // In the level arena: it stays there until the level is unloaded
+			Pipe *pipe; // NULL for a box
+			State state;
+			bool modified;
+			bool alwaysModified; // A spawning pipe changes with time alone
+
+			bool operator<(const TemplateItem& _other) const { return id < _other.id; };
+		};
+
+		void Record(const LevelInfo& _info, const LevelDescription& _level);
+		void Clear();
+		bool IsEmpty() const { return m_characters.empty(); };
+
+		void MarkModified(const DisplayableObject& _item); // When it changes. Only kept the first time since the start, ignored for what isn't in the template (characters)
+		void CreateCharacters(EventEngine *_eventEngine, LevelDescription& _level);
+
+		/* Calls _restorer(DisplayableObject& item, Pipe* pipe, State initialState) for each item marked since the start, pipe being NULL for a box. They're not marked anymore after it */
+		template <typename Restorer>
+		void RestoreModifiedItems(Restorer _restorer)
+		{
+			unsigned int nbStillModified = 0;
+			for (unsigned int i = 0; i < m_modifiedItems.size(); i++)
+			{
+				TemplateItem& item = m_items[m_modifiedItems[i]];
+				_restorer(*item.item, item.pipe, item.state);
+				if (item.alwaysModified)
+					m_modifiedItems[nbStillModified++] = m_modifiedItems[i];
+				else
+					item.modified = false;
+			}
+			m_modifiedItems.resize(nbStillModified);
+		};
+
+		unsigned int GetNbModifiedItems() const { return m_modifiedItems.size(); };
+
+		/* Hot reload: the elements of the new file are compared with these, then only the differences are changed here */
+		const LevelInfo& GetLevelInfo() const { return m_info; };
+		const std::vector<TemplateCharacter>& GetCharacters() const { return m_characters; };
+		const std::vector<TemplateItem>& GetItems() const { return m_items; };
+		void SetLevelInfo(const LevelInfo& _info) { m_info = _info; };
+		void SetCharacterPosition(unsigned int _index, sf::Vector2f _position) { m_characters[_index].position = _position; };
+		void SetItemState(unsigned int _index, State _state) { m_items[_index].state = _state; };
+		void Remove(const std::vector<bool>& _removedCharacters, const std::vector<bool>& _removedItems); // One flag per character, per item
+		void Add(const LevelDescription& _level); // Objects created after the ones already there
+
+	private:
+		LevelInfo m_info;
+		std::vector<TemplateCharacter> m_characters;
+		std::vector<TemplateItem> m_items; // Sorted by id
+		std::vector<unsigned int> m_modifiedItems; // Indexes in m_items
+};
+
+#endif
@@ -0,0 +1,397 @@
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include "TileLayer.hpp"
+
+TileLayer::TileLayer() : m_x(0), m_y(0), m_nbColumns(0), m_nbRows(0)
+{
+}
+
+bool TileLayer::Read(XmlStreamReader *_reader)
+{
+	// The layer starts at the corner of the level by default
+	float x = !_reader->GetAttribute("x").IsNull() ? _reader->GetAttributeAsFloat("x") : 0;
+	float y = !_reader->GetAttribute("y").IsNull() ? _reader->GetAttributeAsFloat("y") : 0;
+	int nbColumns = _reader->GetAttributeAsInt("columns");
+	int nbRows = _reader->GetAttributeAsInt("rows");
+	std::string tileset = _reader->GetAttribute("tileset").ToString();
+	std::string encoding = _reader->GetAttribute("encoding").ToString();
+
+	std::string data;
+	if (!_reader->IsEmptyElement())
+	{
+		while (_reader->Read() && _reader->GetNodeType() != XML_ELEMENT_END)
+		{
+			if (_reader->GetNodeType() == XML_TEXT)
+				data.append(_reader->GetNodeData().data, _reader->GetNodeData().size);
+		}
+	}
+
+	return Decode(x, y, nbColumns, nbRows, tileset, encoding, data.c_str());
+}
+
+bool TileLayer::Decode(float _x, float _y, int _nbColumns, int _nbRows, const std::string& _tileset, const std::string& _encoding, const char* _data)
+{
+	m_x = _x;
+	m_y = _y;
+	m_nbColumns = _nbColumns > 0 ? _nbColumns : 0;
+	m_nbRows = _nbRows > 0 ? _nbRows : 0;
+
+	m_tileset = GetSpriteNames(_tileset);
+
+	// The size comes from the attributes: checked before anything is allocated for it. Base64 has 3 bytes per 4 characters, rle any number of cells per run
+	m_cells.clear();
+	bool decoded = false;
+	if (IsSizeValid(_nbColumns, _nbRows))
+	{
+		unsigned int nbCells = m_nbColumns * m_nbRows;
+		if (_encoding == "rle")
+		{
+			m_cells.reserve(nbCells);
+			decoded = DecodeRuns(_data);
+		}
+		else if (_encoding == "base64" && nbCells * 2 <= strlen(_data) * 3 / 4)
+		{
+			m_cells.reserve(nbCells);
+			decoded = DecodeBase64(_data);
+		}
+	}
+
+	for (unsigned int i = 0; decoded && i < m_cells.size(); i++)
+		decoded = m_cells[i] <= m_tileset.size();
+
+	if (!decoded || m_nbColumns == 0 || m_nbRows == 0 || _x < 0 || _y < 0)
+	{
+		std::cerr << "Can't read tile layer at " << _x << ", " << _y << ". No tile created." << std::endl;
+		m_cells.clear();
+		m_nbColumns = 0;
+		m_nbRows = 0;
+		return false;
+	}
+	return true;
+}
+
+bool TileLayer::IsSizeValid(int _nbColumns, int _nbRows)
+{
+	return _nbColumns > 0 && _nbRows > 0 && (unsigned long long)_nbColumns * (unsigned long long)_nbRows <= MaxNbCells;
+}
+
+bool TileLayer::DecodeRuns(const char* _data)
+{
+	const unsigned int nbCells = m_nbColumns * m_nbRows;
+	const char* current = _data;
+	while (*current != '\0')
+	{
+		while (isspace((unsigned char)*current) || *current == ',')
+			current++;
+		if (*current == '\0')
+			break;
+
+		char* end;
+		unsigned long count = 1;
+		unsigned long cell = strtoul(current, &end, 10);
+		if (end == current)
+			return false;
+		if (*end == '*')
+		{
+			count = cell;
+			current = end + 1;
+			cell = strtoul(current, &end, 10);
+			if (end == current)
+				return false;
+		}
+		current = end;
+
+		if (cell > 0xFFFF || count > nbCells - m_cells.size())
+			return false;
+		m_cells.insert(m_cells.end(), count, (unsigned short)cell);
+	}
+	return m_cells.size() == nbCells;
+}
+
+bool TileLayer::DecodeBase64(const char* _data)
+{
+	const unsigned int nbCells = m_nbColumns * m_nbRows;
+	unsigned int bits = 0;
+	unsigned int nbBits = 0;
+	bool lowByteRead = false;
+	unsigned char lowByte = 0;
+
+	for (const char* current = _data; *current != '\0' && *current != '='; current++)
+	{
+		if (isspace((unsigned char)*current))
+			continue;
+		int value = GetBase64Value(*current);
+		if (value < 0)
+			return false;
+
+		bits = ((bits << 6) | value) & 0xFFFF;
+		nbBits += 6;
+		if (nbBits >= 8)
+		{
+			nbBits -= 8;
+			unsigned char byte = (unsigned char)(bits >> nbBits);
+			if (!lowByteRead)
+				lowByte = byte;
+			else if (m_cells.size() < nbCells)
+				m_cells.push_back((unsigned short)(lowByte | (byte << 8)));
+			else
+				return false;
+			lowByteRead = !lowByteRead;
+		}
+	}
+	return m_cells.size() == nbCells && !lowByteRead;
+}
+
+std::vector<std::string> TileLayer::GetSpriteNames(const std::string& _tileset)
+{
+	std::istringstream names(_tileset);
+	std::string name;
+	std::vector<std::string> spriteNames;
+	while (names >> name)
+		spriteNames.push_back("floor_" + name);
+	return spriteNames;
+}
+
+int TileLayer::GetBase64Value(char _c)
+{
+	if (_c >= 'A' && _c <= 'Z')
+		return _c - 'A';
+	if (_c >= 'a' && _c <= 'z')
+		return _c - 'a' + 26;
+	if (_c >= '0' && _c <= '9')
+		return _c - '0' + 52;
+	if (_c == '+')
+		return 62;
+	if (_c == '/')
+		return 63;
+	return -1;
+}
+
+/* As DecodeRuns and DecodeBase64, but the first run or group is cut by _span.skip, and the last one where the span ends */
+bool TileLayer::DecodeSpan(const TileLayerSpan& _span, bool _base64, const char* _data, std::vector<unsigned short>& _cells)
+{
+	_cells.clear();
+	_cells.reserve(_span.nbColumns);
+	const char* end = _data + _span.length;
+	unsigned int skip = _span.skip;
+
+	if (!_base64)
+	{
+		for (const char* current = _data; current < end && _cells.size() < _span.nbColumns; )
+		{
+			if (isspace((unsigned char)*current) || *current == ',')
+			{
+				current++;
+				continue;
+			}
+
+			char* numberEnd;
+			unsigned long count = 1;
+			unsigned long cell = strtoul(current, &numberEnd, 10);
+			if (numberEnd == current)
+				return false;
+			if (*numberEnd == '*')
+			{
+				count = cell;
+				current = numberEnd + 1;
+				cell = strtoul(current, &numberEnd, 10);
+				if (numberEnd == current)
+					return false;
+			}
+			current = numberEnd;
+
+			if (cell > 0xFFFF || count < skip)
+				return false;
+			count = std::min(count - skip, (unsigned long)(_span.nbColumns - _cells.size()));
+			skip = 0;
+			_cells.insert(_cells.end(), count, (unsigned short)cell);
+		}
+		return _cells.size() == _span.nbColumns;
+	}
+
+	unsigned int bits = 0;
+	unsigned int nbBits = 0;
+	bool lowByteRead = false;
+	unsigned char lowByte = 0;
+	for (const char* current = _data; current < end && *current != '=' && _cells.size() < _span.nbColumns; current++)
+	{
+		if (isspace((unsigned char)*current))
+			continue;
+		int value = GetBase64Value(*current);
+		if (value < 0)
+			return false;
+
+		bits = ((bits << 6) | value) & 0xFFFF;
+		nbBits += 6;
+		if (nbBits >= 8)
+		{
+			nbBits -= 8;
+			unsigned char byte = (unsigned char)(bits >> nbBits);
+			if (skip > 0)
+				skip--; // Bytes of the cells before the span: they're not paired
+			else
+			{
+				if (lowByteRead)
+					_cells.push_back((unsigned short)(lowByte | (byte << 8)));
+				else
+					lowByte = byte;
+				lowByteRead = !lowByteRead;
+			}
+		}
+	}
+	return _cells.size() == _span.nbColumns;
+}
+
+TileLayerIndexer::TileLayerIndexer() : m_layer(0), m_nbColumns(0), m_nbRows(0), m_base64(false), m_valid(false), m_nbUnits(0), m_nextCut(0), m_nextRow(0), m_previousEnd(0),
+	m_start(0), m_end(0), m_nbCharacters(0), m_star(false), m_digitsAfterStar(false), m_paddingRead(false)
+{
+	m_numbers[0] = 0;
+	m_numbers[1] = 0;
+}
+
+void TileLayerIndexer::Begin(unsigned int _layer, unsigned int _nbColumns, unsigned int _nbRows, bool _base64, const std::vector<unsigned int>& _cuts)
+{
+	m_layer = _layer;
+	m_nbColumns = _nbColumns;
+	m_nbRows = _nbRows;
+	m_base64 = _base64;
+	m_cuts = _cuts;
+	m_valid = (unsigned long long)_nbColumns * _nbRows <= TileLayer::MaxNbCells && _nbColumns > 0 && _nbRows > 0 && !_cuts.empty() && _cuts[0] == 0 && _cuts.back() < _nbColumns;
+	m_spans.clear();
+
+	m_nbUnits = 0;
+	m_nextCut = 0;
+	m_nextRow = 0;
+	m_previousEnd = 0;
+	m_nbCharacters = 0;
+	m_numbers[0] = 0;
+	m_numbers[1] = 0;
+	m_star = false;
+	m_digitsAfterStar = false;
+	m_paddingRead = false;
+}
+
+/* The same characters as DecodeRuns and DecodeBase64 accept */
+void TileLayerIndexer::Feed(char _c, unsigned int _offset)
+{
+	if (!m_valid || m_paddingRead)
+		return;
+
+	if (isspace((unsigned char)_c) || (!m_base64 && _c == ','))
+	{
+		if (!m_base64)
+			FinishRunOrGroup();
+		return;
+	}
+
+	if (m_base64)
+	{
+		if (_c == '=')
+		{
+			m_paddingRead = true;
+			FinishRunOrGroup();
+			return;
+		}
+		m_valid = TileLayer::GetBase64Value(_c) >= 0;
+	}
+	else if (_c == '*')
+	{
+		m_valid = m_nbCharacters > 0 && !m_star;
+		m_star = true;
+	}
+	else if (_c >= '0' && _c <= '9')
+	{
+		unsigned long& number = m_numbers[m_star ? 1 : 0];
+		number = number * 10 + (_c - '0');
+		m_digitsAfterStar = m_star;
+		m_valid = number <= 0xFFFFFFFu; // Far more than a grid has cells
+	}
+	else
+		m_valid = false;
+
+	if (m_nbCharacters == 0)
+		m_start = _offset;
+	m_end = _offset + 1;
+	m_nbCharacters++;
+	if (m_base64 && m_nbCharacters == 4)
+		FinishRunOrGroup();
+}
+
+bool TileLayerIndexer::End(std::vector<TileLayerSpan>& _spans)
+{
+	FinishRunOrGroup();
+	unsigned int nbUnits = m_nbColumns * m_nbRows * (m_base64 ? 2 : 1);
+	bool indexed = m_valid && m_nbUnits == nbUnits && !m_spans.empty();
+	if (indexed)
+	{
+		m_spans.back().length = m_previousEnd - m_spans.back().offset;
+		_spans.insert(_spans.end(), m_spans.begin(), m_spans.end());
+	}
+	m_spans.clear();
+	return indexed;
+}
+
+void TileLayerIndexer::FinishRunOrGroup()
+{
+	if (m_nbCharacters == 0 || !m_valid)
+		return;
+
+	if (m_base64)
+		Cover(m_nbCharacters * 6 / 8);
+	else
+	{
+		m_valid = (!m_star || m_digitsAfterStar) && m_numbers[m_star ? 1 : 0] <= 0xFFFF;
+		Cover(m_star ? (unsigned int)m_numbers[0] : 1);
+	}
+
+	m_previousEnd = m_end;
+	m_nbCharacters = 0;
+	m_numbers[0] = 0;
+	m_numbers[1] = 0;
+	m_star = false;
+	m_digitsAfterStar = false;
+}
+
+/* A span ends with the run or group that has its last cell: this one, if the next span starts after its first unit, the previous one otherwise */
+void TileLayerIndexer::Cover(unsigned int _nbUnits)
+{
+	unsigned int nbUnits = m_nbColumns * m_nbRows * (m_base64 ? 2 : 1);
+	if (!m_valid || _nbUnits > nbUnits - m_nbUnits)
+	{
+		m_valid = false;
+		return;
+	}
+
+	while (m_nextRow < m_nbRows && GetNextCutUnit() < m_nbUnits + _nbUnits)
+	{
+		unsigned int unit = GetNextCutUnit();
+		if (!m_spans.empty())
+			m_spans.back().length = (unit > m_nbUnits ? m_end : m_previousEnd) - m_spans.back().offset;
+
+		TileLayerSpan span;
+		span.layer = m_layer;
+		span.row = m_nextRow;
+		span.firstColumn = m_cuts[m_nextCut];
+		span.nbColumns = (m_nextCut + 1 < m_cuts.size() ? m_cuts[m_nextCut + 1] : m_nbColumns) - span.firstColumn;
+		span.offset = m_start;
+		span.length = 0;
+		span.skip = unit - m_nbUnits;
+		m_spans.push_back(span);
+
+		if (++m_nextCut == m_cuts.size())
+		{
+			m_nextCut = 0;
+			m_nextRow++;
+		}
+	}
+	m_nbUnits += _nbUnits;
+}
+
+unsigned int TileLayerIndexer::GetNextCutUnit() const
+{
+	return (m_nextRow * m_nbColumns + m_cuts[m_nextCut]) * (m_base64 ? 2 : 1);
+}
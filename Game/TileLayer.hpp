@@ -0,0 +1,106 @@
+#ifndef TILELAYER_H
+#define TILELAYER_H
+
+#include <string>
+#include <vector>
+#include "../System/XmlStreamReader.hpp"
+
+/*
+*	<tile_layer> of the level files: the floor tiles of a rectangle of the level as one grid, row by row, instead of one <floor_tile> each
+*	A cell is 0 (no tile) or the position of its sprite in the tileset attribute, from 1. The grid is written
+*	- rle: "count*cell" or "cell" separated by commas, e.g. "130*0,1,62*2,3"
+*	- base64: the cells as 16-bit little-endian integers
+*/
+
+/* Part of one row of the grid of a layer, as it's written in the level file: it's decoded without the rest of the grid (see TileLayerIndexer) */
+struct TileLayerSpan
+{
+	unsigned int layer;			// Index of the layer in the file
+	unsigned int row;
+	unsigned int firstColumn;
+	unsigned int nbColumns;
+	unsigned int offset;		// In the file, of the run (rle) or group of 4 characters (base64) that has the first cell
+	unsigned int length;		// Up to the end of the one that has the last cell
+	unsigned int skip;			// Cells (rle) or bytes (base64) of that run or group before the first cell
+};
+
+class TileLayer
+{
+	public:
+		static const unsigned int MaxNbCells = 1 << 24; // Far more than a level has: 16 times the widest benchmark level. A grid of 32 MB
+
+		TileLayer();
+
+		bool Read(XmlStreamReader *_reader); // _reader is on the <tile_layer> element, its content is read too
+		bool Decode(float _x, float _y, int _nbColumns, int _nbRows, const std::string& _tileset, const std::string& _encoding, const char* _data);
+
+		/* The _span.nbColumns cells of a span, from the _span.length characters at its offset. False if they aren't a valid part of a grid */
+		static bool DecodeSpan(const TileLayerSpan& _span, bool _base64, const char* _data, std::vector<unsigned short>& _cells);
+		static std::vector<std::string> GetSpriteNames(const std::string& _tileset); // "floor_" included
+		static bool IsSizeValid(int _nbColumns, int _nbRows); // At least a cell, at most MaxNbCells
+
+		float GetX() const { return m_x; };
+		float GetY() const { return m_y; };
+		unsigned int GetNbColumns() const { return m_nbColumns; };
+		unsigned int GetNbRows() const { return m_nbRows; };
+		const std::vector<std::string>& GetTileset() const { return m_tileset; }; // Sprite names, "floor_" included
+		unsigned short GetCell(unsigned int _column, unsigned int _row) const { return m_cells[_row * m_nbColumns + _column]; };
+
+	private:
+		float m_x;
+		float m_y;
+		unsigned int m_nbColumns;
+		unsigned int m_nbRows;
+		std::vector<std::string> m_tileset;
+		std::vector<unsigned short> m_cells;
+
+		bool DecodeRuns(const char* _data);
+		bool DecodeBase64(const char* _data);
+
+		static int GetBase64Value(char _c); // -1 if _c isn't a base64 digit
+
+		friend class TileLayerIndexer;
+};
+
+/*
+*	Cuts the grid of a <tile_layer> in spans while the level file is indexed (see LevelStreamer), one character of its text at a time:
+*	each row is cut at the given columns, the grid is neither decoded nor kept
+*/
+class TileLayerIndexer
+{
+	public:
+		TileLayerIndexer();
+
+		void Begin(unsigned int _layer, unsigned int _nbColumns, unsigned int _nbRows, bool _base64, const std::vector<unsigned int>& _cuts); // _cuts: first column of each span of a row, sorted, from 0
+		void Feed(char _c, unsigned int _offset);
+		bool End(std::vector<TileLayerSpan>& _spans); // False if the text isn't a grid of the size of the layer: no span then
+
+	private:
+		unsigned int m_layer;
+		unsigned int m_nbColumns;
+		unsigned int m_nbRows;
+		bool m_base64;
+		std::vector<unsigned int> m_cuts;
+		bool m_valid;
+		std::vector<TileLayerSpan> m_spans;
+
+		unsigned int m_nbUnits;			// Cells (rle) or bytes (base64) read so far
+		unsigned int m_nextCut;			// Index in m_cuts of the next span to start
+		unsigned int m_nextRow;
+		unsigned int m_previousEnd;		// Offset after the last run or group read
+
+		// Run or group being read
+		unsigned int m_start;
+		unsigned int m_end;
+		unsigned int m_nbCharacters;
+		unsigned long m_numbers[2];		// rle: count and cell, or cell alone
+		bool m_star;
+		bool m_digitsAfterStar;
+		bool m_paddingRead;				// base64: '=' ends the data
+
+		void FinishRunOrGroup();
+		void Cover(unsigned int _nbUnits); // The run or group just read covers that many units: the spans that start in it are started
+		unsigned int GetNextCutUnit() const;
+};
+
+#endif
@@ -0,0 +1,120 @@
+#include <cstring>
+#include "DrawList.hpp"
+#include "../System/AllocationTripwire.hpp"
+
+// A new handle is inserted where the search ended: the items of a level come by increasing handle, so that's the end of the map, without a second search
+DrawItem& DrawList::GetOrAdd(unsigned int _handle, unsigned char _layer)
+{
+	std::map<unsigned int, unsigned int>::iterator it = m_indexOfHandle.lower_bound(_handle);
+	if (it != m_indexOfHandle.end() && it->first == _handle)
+		return m_items[it->second];
+
+	AllocationTripwire::ExpectedAllocations expectedAllocations; // A new object: its node in the map, and room in the arrays if they're full
+	DrawItem item;
+	item.handle = _handle;
+	item.layer = _layer;
+	item.depth = 0;
+	item.textureIndex = 0;
+	m_indexOfHandle.insert(it, std::make_pair(_handle, (unsigned int)m_items.size()));
+	m_items.push_back(item);
+	if (m_entries.capacity() < m_items.capacity())
+		Reserve(m_items.capacity());
+	return m_items.back();
+}
+
+void DrawList::Reserve(unsigned int _nbItems)
+{
+	m_items.reserve(_nbItems);
+	m_entries.reserve(_nbItems);
+	m_scratch.reserve(_nbItems);
+	m_order.reserve(_nbItems);
+}
+
+DrawItem* DrawList::Find(unsigned int _handle)
+{
+	std::map<unsigned int, unsigned int>::iterator it = m_indexOfHandle.find(_handle);
+	return it != m_indexOfHandle.end() ? &m_items[it->second] : NULL;
+}
+
+// The last item takes the place of the removed one: the order doesn't matter, it's given by the keys
+void DrawList::Remove(unsigned int _handle)
+{
+	std::map<unsigned int, unsigned int>::iterator it = m_indexOfHandle.find(_handle);
+	if (it == m_indexOfHandle.end())
+		return;
+
+	unsigned int index = it->second;
+	m_indexOfHandle.erase(it);
+	if (index != m_items.size() - 1)
+	{
+		m_items[index] = m_items.back();
+		m_indexOfHandle[m_items[index].handle] = index;
+	}
+	m_items.pop_back();
+}
+
+const std::vector<unsigned int>& DrawList::Sort()
+{
+	m_entries.resize(m_items.size());
+	for (unsigned int i = 0; i < m_items.size(); i++)
+	{
+		m_entries[i].key = MakeKey(m_items[i]);
+		m_entries[i].index = i;
+	}
+
+	RadixSort();
+
+	m_order.resize(m_entries.size());
+	for (unsigned int i = 0; i < m_entries.size(); i++)
+		m_order[i] = m_entries[i].index;
+	return m_order;
+}
+
+unsigned long long DrawList::MakeKey(const DrawItem& _item)
+{
+	return ((unsigned long long)_item.layer << 56)
+		| ((unsigned long long)_item.depth << 40)
+		| ((unsigned long long)(_item.textureIndex & 0xFFFF) << 24)
+		| (unsigned long long)(_item.handle & 0xFFFFFF);
+}
+
+/* LSD radix sort, one byte per pass. A pass is skipped when all the keys have the same byte (e.g. the layer when there's only one, the depth) */
+void DrawList::RadixSort()
+{
+	unsigned int size = m_entries.size();
+	if (size < 2)
+		return;
+
+	m_scratch.resize(size);
+	SortEntry* src = &m_entries[0];
+	SortEntry* dest = &m_scratch[0];
+
+	for (unsigned int shift = 0; shift < 64; shift += 8)
+	{
+		unsigned int count[256];
+		memset(count, 0, sizeof(count));
+		for (unsigned int i = 0; i < size; i++)
+			count[(src[i].key >> shift) & 0xFF]++;
+
+		if (count[(src[0].key >> shift) & 0xFF] == size)
+			continue;
+
+		unsigned int offset = 0;
+		for (unsigned int digit = 0; digit < 256; digit++)
+		{
+			unsigned int nb = count[digit];
+			count[digit] = offset;
+			offset += nb;
+		}
+
+		for (unsigned int i = 0; i < size; i++)
+			dest[count[(src[i].key >> shift) & 0xFF]++] = src[i];
+
+		SortEntry* tmp = src;
+		src = dest;
+		dest = tmp;
+	}
+
+	if (src != &m_entries[0])
+		memcpy(&m_entries[0], src, size * sizeof(SortEntry));
+}
@@ -0,0 +1,55 @@
+#ifndef DRAWLIST_H
+#define DRAWLIST_H
+
+#include <map>
+#include <vector>
+#include <SFML/Graphics.hpp>
+
+struct DrawItem
+{
+	sf::Sprite sprite;
+	unsigned int handle;		// Id of the DisplayableObject
+	unsigned char layer;		// RenderLayer
+	unsigned short depth;		// Order inside the layer, the smallest first
+	unsigned int textureIndex;	// See SpriteHandler, used to group the draws by texture
+};
+
+/*
+	Everything gfx draws, in one flat array. The draw order comes from a 64 bits key per item, sorted every frame:
+	layer (8 bits) | depth (16 bits) | texture (16 bits) | handle (24 bits)
+	Draws that use the same texture end up next to each other, and a new layer is only a new value in the key
+*/
+class DrawList
+{
+	public:
+		DrawItem& GetOrAdd(unsigned int _handle, unsigned char _layer);
+		DrawItem* Find(unsigned int _handle);
+		void Remove(unsigned int _handle);
+		void Reserve(unsigned int _nbItems); // The arrays of Sort too: it never allocates
+
+		unsigned int GetSize() const { return m_items.size(); };
+		unsigned int GetCapacity() const { return m_items.capacity(); };
+		DrawItem& GetItem(unsigned int _index) { return m_items[_index]; };
+
+		const std::vector<unsigned int>& Sort(); // Indexes of the items, in draw order
+
+	private:
+		struct SortEntry
+		{
+			unsigned long long key;
+			unsigned int index;
+		};
+
+		std::vector<DrawItem> m_items;
+		std::map<unsigned int, unsigned int> m_indexOfHandle;
+
+		// Kept from one frame to the next so that sorting doesn't allocate
+		std::vector<SortEntry> m_entries;
+		std::vector<SortEntry> m_scratch;
+		std::vector<unsigned int> m_order;
+
+		static unsigned long long MakeKey(const DrawItem& _item);
+		void RadixSort();
+};
+
+#endif // DRAWLIST_H
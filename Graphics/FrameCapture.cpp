@@ -0,0 +1,123 @@
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include "FrameCapture.hpp"
+
+FrameCapture::FrameCapture(const std::string& _directory, CaptureFormat _format, unsigned int _queueSize)
+{
+	m_directory = _directory;
+	m_format = _format;
+	m_queueSize = _queueSize > 0 ? _queueSize : 1;
+	m_stopping = false;
+	m_nbWritten = 0;
+	m_nbDropped = 0;
+	m_maxQueueDepth = 0;
+
+	// Allocated once, the buffers keep their size from one frame to the next
+	m_frames.resize(m_queueSize);
+	for (unsigned int i = 0; i < m_frames.size(); i++)
+		m_freeFrames.push_back(&m_frames[i]);
+
+	m_writer = std::thread(&FrameCapture::WriteFrames, this);
+}
+
+// The frames already captured are written before leaving
+FrameCapture::~FrameCapture()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stopping = true;
+	}
+	m_frameSubmitted.notify_one();
+	m_writer.join();
+
+	PrintStats();
+}
+
+CapturedFrame* FrameCapture::AcquireFrame(unsigned int _number)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (m_freeFrames.empty())
+	{
+		m_nbDropped++;
+		return NULL;
+	}
+
+	CapturedFrame* frame = m_freeFrames.back();
+	m_freeFrames.pop_back();
+	frame->number = _number;
+	return frame;
+}
+
+void FrameCapture::SubmitFrame(CapturedFrame* _frame)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_queue.push_back(_frame);
+		if (m_queue.size() > m_maxQueueDepth)
+			m_maxQueueDepth = m_queue.size();
+	}
+	m_frameSubmitted.notify_one();
+}
+
+void FrameCapture::ReleaseFrame(CapturedFrame* _frame)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_freeFrames.push_back(_frame);
+}
+
+// Writer thread: encoding and writing happen without the lock
+void FrameCapture::WriteFrames()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (true)
+	{
+		while (m_queue.empty() && !m_stopping)
+			m_frameSubmitted.wait(lock);
+		if (m_queue.empty())
+			return;
+
+		CapturedFrame* frame = m_queue.front();
+		m_queue.pop_front();
+
+		lock.unlock();
+		bool written = WriteFrame(*frame);
+		lock.lock();
+
+		if (written)
+		{
+			m_nbWritten++;
+			m_frameSize = frame->size;
+		}
+		m_freeFrames.push_back(frame);
+	}
+}
+
+bool FrameCapture::WriteFrame(const CapturedFrame& _frame)
+{
+	char fileName[32];
+	sprintf(fileName, "frame_%06u.%s", _frame.number, m_format == CAPTURE_PNG ? "png" : "rgba");
+	std::string path = m_directory + "/" + fileName;
+
+	if (m_format == CAPTURE_PNG)
+	{
+		sf::Image image;
+		image.create(_frame.size.x, _frame.size.y, &_frame.pixels[0]);
+		return image.saveToFile(path);
+	}
+
+	std::ofstream file(path.c_str(), std::ios::binary);
+	file.write(reinterpret_cast<const char*>(&_frame.pixels[0]), _frame.pixels.size());
+	if (!file)
+	{
+		std::cerr << "Error: could not write captured frame " << path << std::endl;
+		return false;
+	}
+	return true;
+}
+
+void FrameCapture::PrintStats() const
+{
+	std::cout << "Capture: " << m_nbWritten << " frames written in " << m_directory << " (" << m_frameSize.x << "x" << m_frameSize.y << "), "
+		<< m_nbDropped << " dropped, max queue depth " << m_maxQueueDepth << "/" << m_queueSize << std::endl;
+}
@@ -0,0 +1,63 @@
+#ifndef FRAMECAPTURE_H
+#define FRAMECAPTURE_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <SFML/Graphics.hpp>
+
+enum CaptureFormat
+{
+	CAPTURE_RAW,	// RGBA bytes, row by row, no header
+	CAPTURE_PNG
+};
+
+struct CapturedFrame
+{
+	unsigned int number;
+	sf::Vector2u size;
+	std::vector<sf::Uint8> pixels;
+};
+
+/*
+	Writes the rendered frames to disk on a background thread, so that capturing never slows gfx down
+	The frames go through a fixed number of buffers: when they are all waiting to be written, the new frame is dropped
+*/
+class FrameCapture
+{
+	public:
+		FrameCapture(const std::string& _directory, CaptureFormat _format, unsigned int _queueSize = 8);
+		~FrameCapture();
+
+		CapturedFrame* AcquireFrame(unsigned int _number); // NULL if the queue is full: the frame is counted as dropped
+		void SubmitFrame(CapturedFrame* _frame);
+		void ReleaseFrame(CapturedFrame* _frame); // Give back a frame that won't be submitted
+
+	private:
+		std::string m_directory;
+		CaptureFormat m_format;
+		unsigned int m_queueSize;
+
+		std::vector<CapturedFrame> m_frames;
+		std::vector<CapturedFrame*> m_freeFrames;
+		std::deque<CapturedFrame*> m_queue;
+		std::mutex m_mutex;
+		std::condition_variable m_frameSubmitted;
+		bool m_stopping;
+		std::thread m_writer;
+
+		// Stats
+		unsigned int m_nbWritten;
+		unsigned int m_nbDropped;
+		unsigned int m_maxQueueDepth;
+		sf::Vector2u m_frameSize;
+
+		void WriteFrames();
+		bool WriteFrame(const CapturedFrame& _frame);
+		void PrintStats() const;
+};
+
+#endif // FRAMECAPTURE_H
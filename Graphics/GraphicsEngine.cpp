@@ -1,24 +1,50 @@
+#include <algorithm>
+#include <cstdio>
 #include "GraphicsEngine.hpp"
 #include "../Graphics/GraphicsEvents.hpp"
-#include "../System/Listener/CharacterDiedListener.hpp"
-#include "../System/Listener/CharacterPositionUpdateListener.hpp"
+#include "../Graphics/NullRenderer.hpp"
+#include "../Graphics/SoftwareRenderer.hpp"
+#include "../Graphics/WindowRenderer.hpp"
+#include "../Game/GameEvents.hpp"
+#include "../System/AllocationTripwire.hpp"
+#include "../System/FrameArena.hpp"
+#include "../System/SpriteRegistry.hpp"
 #include "../System/Listener/DebugInfoUpdatedListener.hpp"
-#include "../System/Listener/ForegroundItemRemovedListener.hpp"
-#include "../System/Listener/ForegroundItemUpdatedListener.hpp"
 #include "../System/Listener/GotLevelInfoListener.hpp"
-#include "../System/Listener/NewForegroundItemReadListener.hpp"
-#include "../System/Listener/NewPipeReadListener.hpp"
+#include "../System/Listener/RenderCommandsReadyListener.hpp"
+#include "../System/Listener/TileMapLoadedListener.hpp"
 
 const float GraphicsEngine::FramerateLimit = 60;
+const unsigned int GraphicsEngine::BackgroundHandle = 0xFFFFFFFF;
 
-GraphicsEngine::GraphicsEngine(EventEngine *_eventEngine): Engine (_eventEngine)
+GraphicsEngine::GraphicsEngine(EventEngine *_eventEngine, RendererType _rendererType): Engine (_eventEngine)
 {
-	m_gameWindow = new sf::RenderWindow(sf::VideoMode(WIN_WIDTH, WIN_HEIGHT, 32), "Super Mario !", sf::Style::Titlebar | sf::Style::Close);
+	switch (_rendererType)
+	{
+		case NULL_RENDERER:
+			m_renderer = new NullRenderer();
+			break;
+		case SOFTWARE_RENDERER:
+			m_renderer = new SoftwareRenderer(WIN_WIDTH, WIN_HEIGHT);
+			break;
+		default:
+			m_renderer = new WindowRenderer(WIN_WIDTH, WIN_HEIGHT, "Super Mario !");
+			break;
+	}
 
-	m_spriteHandler = new SpriteHandler();
+	m_spriteHandler = new SpriteHandler(_rendererType == WINDOW_RENDERER, m_renderer->NeedsPixels());
 	m_spriteHandler->LoadTextures();
+	if (m_renderer->NeedsPixels())
+	{
+		for (unsigned int i = 0; i < m_spriteHandler->GetNbTextures(); i++)
+			m_renderer->LoadTexture(m_spriteHandler->GetTexture(i), m_spriteHandler->GetPixels(i));
+	}
 
-	m_tmpSprite = new sf::Sprite();
+	m_renderCommands = NULL;
+	m_tileMap = NULL;
+	m_frameCapture = NULL;
+	m_frameNumber = 0;
+	m_marioSpriteId = SpriteRegistry::GetId("mario");
 
 	CreateListeners();
 #ifdef DEBUG_MODE
@@ -32,70 +58,112 @@ GraphicsEngine::GraphicsEngine(EventEngine *_eventEngine): Engine (_eventEngine)
 
 void GraphicsEngine::CreateListeners()
 {
-	CharacterDiedListener* characterDiedListener = new CharacterDiedListener(this);
-	m_eventEngine->addListener("game.character_died", characterDiedListener);
-	m_createdListeners.push_back(characterDiedListener);
-
-	CharacterPositionUpdateListener* characterPositionUpdateListener = new CharacterPositionUpdateListener(this);
-	m_eventEngine->addListener("game.character_position_updated", characterPositionUpdateListener);
-	m_createdListeners.push_back(characterPositionUpdateListener);
 #ifdef DEBUG
 	DebugInfoUpdatedListener* debugInfoUpdatedListener = new DebugInfoUpdatedListener(this);
 	m_eventEngine->addListener("game.debug_info_updated", debugInfoUpdatedListener);
 	m_createdListeners.push_back(debugInfoUpdatedListener);
 #endif
-	ForegroundItemRemovedListener* foregroundItemRemovedListener = new ForegroundItemRemovedListener(this);
-	m_eventEngine->addListener("game.foreground_item_removed", foregroundItemRemovedListener);
-	m_createdListeners.push_back(foregroundItemRemovedListener);
-
-	ForegroundItemUpdatedListener* foregroundItemUpdatedListener = new ForegroundItemUpdatedListener(this);
-	m_eventEngine->addListener("game.foreground_item_updated", foregroundItemUpdatedListener);
-	m_createdListeners.push_back(foregroundItemUpdatedListener);
-
 	GotLevelInfoListener* gotLevelInfoListener = new GotLevelInfoListener(this);
 	m_eventEngine->addListener("game.got_level_info", gotLevelInfoListener);
 	m_createdListeners.push_back(gotLevelInfoListener);
 
-	NewForegroundItemReadListener* newForegroundItemReadListener = new NewForegroundItemReadListener(this);
-	m_eventEngine->addListener("game.new_foreground_item_read", newForegroundItemReadListener);
-	m_createdListeners.push_back(newForegroundItemReadListener);
+	RenderCommandsReadyListener* renderCommandsReadyListener = new RenderCommandsReadyListener(this);
+	m_eventEngine->addListener(RENDER_COMMANDS_READY, renderCommandsReadyListener);
+	m_createdListeners.push_back(renderCommandsReadyListener);
 
-	NewPipeReadListener* newPipeReadListener = new NewPipeReadListener(this);
-	m_eventEngine->addListener("game.new_pipe_read", newPipeReadListener);
-	m_createdListeners.push_back(newPipeReadListener);
+	TileMapLoadedListener* tileMapLoadedListener = new TileMapLoadedListener(this);
+	m_eventEngine->addListener(TILE_MAP_LOADED, tileMapLoadedListener);
+	m_createdListeners.push_back(tileMapLoadedListener);
 }
 
 GraphicsEngine::~GraphicsEngine()
 {
+	delete m_frameCapture;
 	delete m_spriteHandler;
-	m_gameWindow->close();
-	delete m_gameWindow;
-	
-	for (std::map<unsigned int, InfoForDisplay*>::iterator it = m_animatedLevelItems.begin(); it != m_animatedLevelItems.end(); ++it)
-		delete(it->second);
+	delete m_renderer;
 }
 
 void GraphicsEngine::Frame()
 {
-	m_gameWindow->clear();
-	ResetSpritesToDraw();
+	m_renderer->Clear();
+	ApplyRenderCommands();
 	UpdateAnimatedLevelSprites();
-	if (m_gameWindow->isOpen())
+	AnimateDisplayableObjects();
+	if (m_renderer->IsOpen())
 		ProcessWindowEvents();
 	DisplayWindow();
 }
 
-void GraphicsEngine::ResetSpritesToDraw()
+/* Everything that changed during the last frame of g, in one pass over a flat array */
+void GraphicsEngine::ApplyRenderCommands()
 {
-	while (!m_backgroundToDraw.empty())
-		m_backgroundToDraw.pop_back();
+	if (m_renderCommands == NULL)
+		return;
+
+	const std::vector<RenderCommand>& commands = m_renderCommands->GetFrontBuffer();
+	if (m_drawList.GetSize() + commands.size() > m_drawList.GetCapacity())
+	{
+		AllocationTripwire::ExpectedAllocations expectedAllocations; // A whole level can come in one frame. Once it's drawn, a frame has fewer commands than the list has room for
+		m_drawList.Reserve(m_drawList.GetSize() + commands.size());
+	}
+	for (unsigned int i = 0; i < commands.size(); i++)
+	{
+		const RenderCommand& command = commands[i];
+		if (command.flags & REMOVE_SPRITE)
+		{
+			RemoveSprite(command);
+			continue;
+		}
+
+		if (command.layer == CHARACTER_LAYER)
+			SetDisplayableObjectToDraw(command);
+		else
+			UpdateForegroundItem(command);
+	}
 }
 
+void GraphicsEngine::RemoveSprite(const RenderCommand& _command)
+{
+	RemoveFromAnimatedTileGroup(_command.handle);
+	m_drawList.Remove(_command.handle);
+	m_renderRecords.erase(_command.handle);
+}
+
+/* One clock per clip: the frame is computed once per group, and only the textures of its tiles are changed, when the frame changes */
 void GraphicsEngine::UpdateAnimatedLevelSprites()
 {
-	for (std::map<unsigned int, InfoForDisplay*>::iterator it = m_animatedLevelItems.begin(); it != m_animatedLevelItems.end(); ++it)
+	for (unsigned int i = 0; i < m_animatedTileGroups.size(); i++)
+	{
+		Sprite::AnimatedTileGroup& group = m_animatedTileGroups[i];
+		if (!m_spriteHandler->Animate(group.clock))
+			continue;
+
+		unsigned int textureIndex = m_spriteHandler->GetCurrentTextureIndex(group.clock);
+		const sf::Texture& texture = m_spriteHandler->GetTexture(textureIndex);
+		for (unsigned int j = 0; j < group.ids.size(); j++)
+		{
+			DrawItem* item = m_drawList.Find(group.ids[j]);
+			if (item != NULL)
+			{
+				item->sprite.setTexture(texture);
+				item->textureIndex = textureIndex;
+			}
+		}
+	}
+}
+
+/* Characters are only sent by g when they changed, but their animation keeps going */
+void GraphicsEngine::AnimateDisplayableObjects()
+{
+	for (unsigned int i = 0; i < m_drawList.GetSize(); i++)
 	{
-		UpdateForegroundItem(it->second);
+		DrawItem& item = m_drawList.GetItem(i);
+		if (item.layer != CHARACTER_LAYER)
+			continue;
+
+		Sprite::RenderRecord& record = m_renderRecords[item.handle];
+		if (m_spriteHandler->Animate(record.spriteInfo))
+			SetTexture(item, m_spriteHandler->GetCurrentTextureIndex(record.spriteInfo), record.reverse);
 	}
 }
 
@@ -104,7 +172,7 @@ void GraphicsEngine::ProcessWindowEvents()
 {
 	sf::Event windowEvent;
 
-	while (m_gameWindow->pollEvent(windowEvent))
+	while (m_renderer->PollEvent(windowEvent))
 	{
 		switch (windowEvent.type)
 		{
@@ -129,154 +197,246 @@ void GraphicsEngine::ProcessWindowEvents()
 
 void GraphicsEngine::DisplayWindow()
 {
-	SetBackgroundToDraw();
-
 	DrawGame();
 
 #ifdef DEBUG_MODE
 	DrawDebugInfo();
 #endif
 
-	m_gameWindow->display();
+	if (m_frameCapture != NULL)
+		CaptureFrame();
+
+	m_renderer->Display();
+	m_frameNumber++;
 }
 
-void GraphicsEngine::SetBackgroundToDraw()
+void GraphicsEngine::StartCapture(const std::string& _directory, CaptureFormat _format)
 {
-	ResetTmpSprite();
-	m_tmpSprite->setTexture(m_spriteHandler->GetTexture("background_" + m_currentBackgroundName));
-	m_backgroundToDraw.push_back(*m_tmpSprite);
+	delete m_frameCapture;
+	m_frameCapture = new FrameCapture(_directory, _format);
 }
 
-void GraphicsEngine::UpdateForegroundItem(const InfoForDisplay *_info)
+void GraphicsEngine::Close()
 {
-	ResetTmpSprite();
-	InfoForDisplay* infoToApplyOnSprite = new InfoForDisplay(*_info); // in order to not modify _info
-	infoToApplyOnSprite->name = GetTextureName(_info->id, _info->name, _info->state);
-	infoToApplyOnSprite->coordinates = AbsoluteToRelative(_info->coordinates);
-	m_spriteHandler->SetDisplayInfoOnSprite(*infoToApplyOnSprite, m_tmpSprite);
+	delete m_frameCapture;
+	m_frameCapture = NULL;
+	m_renderer->Close();
+}
 
-	if (_info->name.find("pipe_") != std::string::npos)
+// Only the copy of the pixels is done here, the frame is written by the thread of FrameCapture. Numbers of dropped frames are missing on disk
+void GraphicsEngine::CaptureFrame()
+{
+	CapturedFrame* frame = m_frameCapture->AcquireFrame(m_frameNumber);
+	if (frame == NULL)
+		return;
+
+	if (m_renderer->CaptureFrame(frame->pixels, frame->size))
+		m_frameCapture->SubmitFrame(frame);
+	else
+		m_frameCapture->ReleaseFrame(frame);
+}
+
+/*	Each background layer is one screen-sized quad with a repeated texture, set once per level
+	Scrolling only moves the texture rect, so the textures stay small whatever the width of the level */
+void GraphicsEngine::SetBackgroundToDraw()
+{
+	for (unsigned int i = 0; i < m_backgroundLayers.size(); i++)
+		m_drawList.Remove(BackgroundHandle - i);
+
+	m_backgroundLayers = m_spriteHandler->GetBackgroundLayers(m_currentBackgroundName);
+	for (unsigned int i = 0; i < m_backgroundLayers.size(); i++)
 	{
-		m_pipeSpritesToDraw[_info->id] = *m_tmpSprite;
+		DrawItem& layer = m_drawList.GetOrAdd(BackgroundHandle - i, BACKGROUND_LAYER);
+		layer.depth = i;
+		layer.textureIndex = m_backgroundLayers[i].textureIndex;
+		layer.sprite.setTexture(m_spriteHandler->GetTexture(layer.textureIndex));
+		layer.sprite.setPosition(0, 0);
 	}
-	else
+	ScrollBackground();
+}
+
+void GraphicsEngine::ScrollBackground()
+{
+	for (unsigned int i = 0; i < m_backgroundLayers.size(); i++)
 	{
-		m_foregroundSpritesToDraw[_info->id] = *m_tmpSprite;
+		DrawItem* layer = m_drawList.Find(BackgroundHandle - i);
+		int left = (int)(m_cameraPosition.x * m_backgroundLayers[i].parallax.x);
+		int top = (int)(m_cameraPosition.y * m_backgroundLayers[i].parallax.y);
+		layer->sprite.setTextureRect(sf::IntRect(left, top, WIN_WIDTH, WIN_HEIGHT));
 	}
+}
 
-	assert(m_spritesCurrentlyDisplayed.find(_info->id) != m_spritesCurrentlyDisplayed.end());
-	if (m_spritesCurrentlyDisplayed[_info->id].state == Sprite::ANIMATED)
-		AddOrUpdateAnimatedLevelItem(_info); // What if it goes from ANIMATED to something else ? It would need to be removed from the list
+void GraphicsEngine::UpdateForegroundItem(const RenderCommand& _command)
+{
+	DrawItem& item = m_drawList.GetOrAdd(_command.handle, _command.layer);
+	ApplyRenderCommand(_command, item);
 
-	// Tell GameEngine what is to be drawn (id and coordinates), so it can handle collisions (the sprite size might have changed)
-	// TODO check that game.foreground_item_updated is not being sent back and forth
-	Event tmpEvent(_info->id, RelativeToAbsolute(m_tmpSprite->getGlobalBounds()));
-	m_eventEngine->dispatch("game.foreground_item_updated", &tmpEvent);
+	if (_command.layer == FOREGROUND_LAYER)
+		UpdateAnimatedTileGroup(item);
 }
 
-void GraphicsEngine::AddOrUpdateAnimatedLevelItem(const InfoForDisplay *_info)
+/* Puts the item in the group of its clip if it's animated, so it follows the clock of this group (and leaves its previous group, if the state changed) */
+void GraphicsEngine::UpdateAnimatedTileGroup(DrawItem& _item)
 {
-	if (m_animatedLevelItems.find(_info->id) != m_animatedLevelItems.end())
-		*(m_animatedLevelItems[_info->id]) = *_info;
-	else
-		m_animatedLevelItems[_info->id] = new InfoForDisplay(*_info); 
-}
+	unsigned int id = _item.handle;
+	const Sprite::SpriteInfo& info = m_renderRecords[id].spriteInfo;
+	std::map<unsigned int, unsigned int>::iterator currentGroup = m_animatedTileGroupOfItem.find(id);
+	unsigned int groupIndex = currentGroup != m_animatedTileGroupOfItem.end() ? currentGroup->second : m_animatedTileGroups.size();
 
+	if (groupIndex == m_animatedTileGroups.size() || m_animatedTileGroups[groupIndex].clock.clip != info.clip)
+	{
+		RemoveFromAnimatedTileGroup(id);
+		if (!m_spriteHandler->IsAnimated(info))
+			return;
 
-void GraphicsEngine::DeleteForegroundItem(unsigned int _id)
-{
-	m_foregroundSpritesToDraw.erase(_id);
+		groupIndex = 0;
+		while (groupIndex < m_animatedTileGroups.size() && m_animatedTileGroups[groupIndex].clock.clip != info.clip)
+			groupIndex++;
+
+		AllocationTripwire::ExpectedAllocations expectedAllocations; // A new tile, or one whose animation changed (a box emptied)
+		if (groupIndex == m_animatedTileGroups.size())
+		{
+			Sprite::AnimatedTileGroup newGroup;
+			newGroup.clock = info;
+			m_animatedTileGroups.push_back(newGroup);
+		}
+
+		m_animatedTileGroups[groupIndex].ids.push_back(id);
+		m_animatedTileGroupOfItem[id] = groupIndex;
+	}
+
+	// In step with the other tiles of the group
+	_item.textureIndex = m_spriteHandler->GetCurrentTextureIndex(m_animatedTileGroups[groupIndex].clock);
+	_item.sprite.setTexture(m_spriteHandler->GetTexture(_item.textureIndex));
 }
 
-void GraphicsEngine::SetDisplayableObjectToDraw(InfoForDisplay _info) /* Need to copy the object, otherwise (by reference) I'd modify it */
+void GraphicsEngine::RemoveFromAnimatedTileGroup(unsigned int _id)
 {
-	ResetTmpSprite();
-	_info.name = GetTextureName(_info.id, _info.name, _info.state);
-	_info.coordinates = AbsoluteToRelative(_info.coordinates);
-	m_spriteHandler->SetDisplayInfoOnSprite(_info, m_tmpSprite);
-
-	/*	gfx can receive the information to display a character several times (if it has been hit for exemple, info is sent fron g to gfx right after the hit)
-	Only the last one received will be displayed */
-	m_displayableObjectsToDraw[_info.id] = *m_tmpSprite;
+	std::map<unsigned int, unsigned int>::iterator currentGroup = m_animatedTileGroupOfItem.find(_id);
+	if (currentGroup == m_animatedTileGroupOfItem.end())
+		return;
 
-	// Tell GameEngine what is to be drawn (id and coordinates), so it can handle collisions (the sprite size might have changed)
-	Event tmpEvent(_info.id, RelativeToAbsolute(m_tmpSprite->getGlobalBounds()));
-	m_eventEngine->dispatch("game.foreground_item_updated", &tmpEvent);
+	std::vector<unsigned int>& ids = m_animatedTileGroups[currentGroup->second].ids;
+	ids.erase(std::find(ids.begin(), ids.end(), _id));
+	m_animatedTileGroupOfItem.erase(currentGroup);
 }
 
-/* Figures out which sprite to display, ie the name of the sprite in the RECT file. The name is fetched only if it's an animation or if the state has changed. */
-std::string GraphicsEngine::GetTextureName(unsigned int _id, std::string _currentName, State _state)
+/*	gfx can receive the information to display a character several times in a frame (if it has been hit for exemple, a command is pushed right after the hit)
+	Only the last one will be displayed */
+void GraphicsEngine::SetDisplayableObjectToDraw(const RenderCommand& _command)
 {
-	std::string newTextureName;
-	std::string fullStateName = m_spriteHandler->GetFullStateName(_currentName, _state);
-	int nbTextures = m_spriteHandler->HowManyLoadedTexturesContainThisName(fullStateName);
+	DrawItem& item = m_drawList.GetOrAdd(_command.handle, CHARACTER_LAYER);
+	ApplyRenderCommand(_command, item);
 
-	if (nbTextures < 0)
+	if (_command.spriteId == m_marioSpriteId)
 	{
-		std::cerr << "ERROR: " << nbTextures << " texture for " << fullStateName << " (name: \"" << _currentName << "\", state: \"" << _state << "\")" << std::endl;
-		assert(false);
+		MoveCameraOnMario(sf::FloatRect(_command.left, _command.top, _command.width, _command.height));
+#ifdef DEBUG_MODE
+		m_posMario.x = _command.left;
+		m_posMario.y = _command.top;
+#endif
 	}
+}
 
-	if (m_spritesCurrentlyDisplayed.find(_id) == m_spritesCurrentlyDisplayed.end())
+/* Updates the retained sprite of an object with what changed since the last update only */
+void GraphicsEngine::ApplyRenderCommand(const RenderCommand& _command, DrawItem& _item)
+{
+	std::map<unsigned int, Sprite::RenderRecord>::iterator it = m_renderRecords.lower_bound(_command.handle);
+	bool newRecord = (it == m_renderRecords.end() || it->first != _command.handle);
+	if (newRecord)
 	{
-		m_spritesCurrentlyDisplayed[_id].name = "";
-		m_spritesCurrentlyDisplayed[_id].framesSinceLastChange = 0;
-		m_spritesCurrentlyDisplayed[_id].state = nbTextures > 1 ? Sprite::ANIMATED : Sprite::NEW_STATIC;
+		// The sprite of the object is resolved to its animations the first time its id is met, then it's only array lookups
+		Sprite::RenderRecord record;
+		record.spriteInfo.entityType = m_spriteHandler->GetEntityType(_command.spriteId);
+		record.spriteInfo.clip = -1;
+		record.spriteInfo.frame = 0;
+		record.spriteInfo.framesSinceLastChange = 0;
+		AllocationTripwire::ExpectedAllocations expectedAllocations; // A new object
+		it = m_renderRecords.insert(it, std::make_pair(_command.handle, record)); // Where the search ended: the end of the map for the objects of a level, sent by increasing id
 	}
 
-	switch (m_spritesCurrentlyDisplayed[_id].state)
+	Sprite::RenderRecord& record = it->second;
+	State state = (State)_command.state;
+	bool reverse = (_command.flags & REVERSE_SPRITE) != 0;
+	sf::FloatRect coordinates(_command.left, _command.top, _command.width, _command.height);
+
+	bool textureChanged = newRecord || reverse != record.reverse;
+	if (newRecord || state != record.state)
 	{
-		case Sprite::UNKNOWN:
-		case Sprite::ANIMATED:
-		case Sprite::NEW_STATIC:
-			newTextureName = m_spriteHandler->GetTextureNameFromStateName(fullStateName, m_spritesCurrentlyDisplayed[_id], nbTextures);
-			break;
-		case Sprite::STATIC:
-			if (fullStateName == m_spritesCurrentlyDisplayed[_id].name) // Sprite same as previously
-				newTextureName = fullStateName;
-			else
-				newTextureName = m_spriteHandler->GetTextureNameFromStateName(fullStateName, m_spritesCurrentlyDisplayed[_id], nbTextures);
-			break;
-		default:
-			throw std::exception();
+		int previousClip = record.spriteInfo.clip;
+		m_spriteHandler->SetState(record.spriteInfo, state);
+		textureChanged = textureChanged || record.spriteInfo.clip != previousClip;
 	}
 
-	m_spritesCurrentlyDisplayed[_id].name = newTextureName;
-	return newTextureName;
+	if (textureChanged)
+		SetTexture(_item, m_spriteHandler->GetCurrentTextureIndex(record.spriteInfo), reverse);
+	if (newRecord || coordinates.left != record.coordinates.left || coordinates.top != record.coordinates.top)
+	{
+		sf::FloatRect relativeCoordinates = AbsoluteToRelative(coordinates);
+		_item.sprite.setPosition(relativeCoordinates.left, relativeCoordinates.top);
+	}
+
+	record.state = state;
+	record.reverse = reverse;
+	record.coordinates = coordinates;
 }
 
-void GraphicsEngine::UpdateAnimationStates(unsigned int _id, std::string _stateFullName, int nbTextures)
+void GraphicsEngine::SetTexture(DrawItem& _item, unsigned int _textureIndex, bool _reverse)
 {
-	if (nbTextures == 1)			// Static
-	{
-		m_spritesCurrentlyDisplayed[_id].state = Sprite::STATIC;
+	m_spriteHandler->SetTextureOnSprite(_textureIndex, _reverse, &_item.sprite);
+	_item.textureIndex = _textureIndex;
+}
 
-		if (_stateFullName != m_spritesCurrentlyDisplayed[_id].name)
-			m_spritesCurrentlyDisplayed[_id].state = Sprite::NEW_STATIC;
-	}
-	else							// Animation
+// Draw the layers in the correct order (see DrawList). The tiles go right after the background
+void GraphicsEngine::DrawGame()
+{
+	const std::vector<unsigned int>& order = m_drawList.Sort();
+	unsigned int i = 0;
+	for (; i < order.size() && m_drawList.GetItem(order[i]).layer == BACKGROUND_LAYER; i++)
+		m_renderer->Draw(m_drawList.GetItem(order[i]).sprite);
+
+	DrawTiles();
+
+	for (; i < order.size(); i++)
+		m_renderer->Draw(m_drawList.GetItem(order[i]).sprite);
+}
+
+void GraphicsEngine::DrawTiles()
+{
+	if (m_tileMap == NULL)
+		return;
+
+	sf::FloatRect view(m_cameraPosition.x, m_cameraPosition.y, WIN_WIDTH, WIN_HEIGHT);
+	m_tileMap->VisitTiles(view, [&](sf::Vector2f _position, unsigned short _typeIndex)
 	{
-		m_spritesCurrentlyDisplayed[_id].state = Sprite::ANIMATED;
-	}
+		sf::Sprite& sprite = m_tileSprites[_typeIndex];
+		sprite.setPosition(AbsoluteToRelative(_position));
+		m_renderer->Draw(sprite);
+	});
 }
 
-// Draw the layers in the correct order
-void GraphicsEngine::DrawGame()
+/* The sprite of each type is set once per level */
+void GraphicsEngine::SetTileMap(const TileMap* _tileMap)
 {
-	for (unsigned int i = 0; i < m_backgroundToDraw.size(); i++)
-		m_gameWindow->draw(m_backgroundToDraw[i]);
-	for (std::map<unsigned int, sf::Sprite>::iterator it = m_foregroundSpritesToDraw.begin(); it != m_foregroundSpritesToDraw.end(); ++it)
-		m_gameWindow->draw(it->second);
-	for (std::map<unsigned int, sf::Sprite>::iterator it = m_pipeSpritesToDraw.begin(); it != m_pipeSpritesToDraw.end(); ++it)
-		m_gameWindow->draw(it->second);
-	for (std::map<unsigned int, sf::Sprite>::iterator it = m_displayableObjectsToDraw.begin(); it != m_displayableObjectsToDraw.end(); ++it)
-		m_gameWindow->draw(it->second);
+	m_tileMap = _tileMap;
+	m_tileSprites.resize(m_tileMap->GetNbTypes());
+	for (unsigned short i = 0; i < m_tileMap->GetNbTypes(); i++)
+	{
+		Sprite::SpriteInfo info;
+		info.entityType = m_spriteHandler->GetEntityType(m_tileMap->GetType(i).spriteId);
+		info.clip = -1;
+		info.frame = 0;
+		info.framesSinceLastChange = 0;
+		m_spriteHandler->SetState(info, NORMAL);
+		m_spriteHandler->SetTextureOnSprite(m_spriteHandler->GetCurrentTextureIndex(info), false, &m_tileSprites[i]);
+	}
 }
 
 void GraphicsEngine::RceiveLevelInfo(LevelInfo *_info)
 {
 	StoreLevelInfo(_info);
 	InitCameraPosition(_info->size.y);
+	SetBackgroundToDraw();
 }
 
 void GraphicsEngine::StoreLevelInfo(LevelInfo *_info)
@@ -291,30 +451,6 @@ void GraphicsEngine::InitCameraPosition(float _levelHeight)
 	m_cameraPosition.y = _levelHeight - WIN_HEIGHT;
 }
 
-void GraphicsEngine::ReceiveCharacterPosition(InfoForDisplay* _info)
-{
-	SetDisplayableObjectToDraw(*_info);
-	if (_info->name == "mario")
-	{
-		MoveCameraOnMario(_info->coordinates);
-#ifdef DEBUG_MODE
-		m_posMario.x = _info->coordinates.left;
-		m_posMario.y = _info->coordinates.top;
-#endif
-	}
-}
-
-void GraphicsEngine::RemoveDisplayableObject(unsigned int _id)
-{
-	m_displayableObjectsToDraw.erase(_id);
-}
-
-void GraphicsEngine::ResetTmpSprite()
-{
-	delete m_tmpSprite;
-	m_tmpSprite = new sf::Sprite();
-}
-
 void GraphicsEngine::MoveCameraOnMario(sf::FloatRect _coordsMario)
 {
 	sf::Vector2f oldCameraPosition = m_cameraPosition;
@@ -336,37 +472,39 @@ void GraphicsEngine::MoveCameraOnMario(sf::FloatRect _coordsMario)
 		m_cameraPosition.y = newCameraY;
 
 	if (m_cameraPosition != oldCameraPosition)
+	{
 		MoveEverythingBy(oldCameraPosition - m_cameraPosition);
+		ScrollBackground();
+	}
 }
 
 void GraphicsEngine::MoveEverythingBy(sf::Vector2f _vect)
 {
-	for (std::map<unsigned int, sf::Sprite>::iterator it = m_foregroundSpritesToDraw.begin(); it != m_foregroundSpritesToDraw.end(); ++it)
-		it->second.move(_vect);
-	for (std::map<unsigned int, sf::Sprite>::iterator it = m_pipeSpritesToDraw.begin(); it != m_pipeSpritesToDraw.end(); ++it)
-		it->second.move(_vect);
-	for (std::map<unsigned int, sf::Sprite>::iterator it = m_displayableObjectsToDraw.begin(); it != m_displayableObjectsToDraw.end(); ++it)
-		it->second.move(_vect);
+	for (unsigned int i = 0; i < m_drawList.GetSize(); i++)
+	{
+		DrawItem& item = m_drawList.GetItem(i);
+		if (item.layer != BACKGROUND_LAYER)
+			item.sprite.move(_vect);
+	}
 }
 
 #ifdef DEBUG_MODE
 void GraphicsEngine::DrawDebugInfo()
 {
-	std::string toWrite;
 	sf::Vector2f playerPos = m_posMario;
 	sf::Vector2f playerVel = m_debugInfo->velocity;
 	sf::Vector2f playerAcc = m_debugInfo->acceleration;
 
-	toWrite += (" Framerate = " + std::to_string(floor((int)1 / m_clock.getElapsedTime().asSeconds())) + "\n");
-	toWrite += (" Position: { " + std::to_string(playerPos.x) + "; " + std::to_string(playerPos.y) + " }\n");
-	toWrite += (" Velocity: { " + std::to_string(playerVel.x) + "; " + std::to_string(playerVel.y) + " }\n");
-	toWrite += (" Acceleration: { " + std::to_string(playerAcc.x) + "; " + std::to_string(playerAcc.y) + " }\n");
-	toWrite += (" State: " + Debug::GetTextForState(m_debugInfo->state) + "\n");
-	toWrite += (" Jump state: " + Debug::GetTextForJumpState(m_debugInfo->jumpState) + "\n");
+	// Only needed until setString has copied it
+	const std::size_t textSize = 512;
+	char *toWrite = static_cast<char*>(FrameArena::Get().Allocate(textSize, 1));
+	snprintf(toWrite, textSize, " Framerate = %f\n Position: { %f; %f }\n Velocity: { %f; %f }\n Acceleration: { %f; %f }\n State: %s\n Jump state: %s\n",
+		floor(1 / m_clock.getElapsedTime().asSeconds()), playerPos.x, playerPos.y, playerVel.x, playerVel.y, playerAcc.x, playerAcc.y,
+		Debug::GetTextForState(m_debugInfo->state).c_str(), Debug::GetTextForJumpState(m_debugInfo->jumpState).c_str());
 
 	m_clock.restart();
 	m_debugText.setString(toWrite);
-	m_gameWindow->draw(m_debugText);
+	m_renderer->Draw(m_debugText);
 }
 #endif
 
@@ -391,7 +529,7 @@ sf::FloatRect GraphicsEngine::RelativeToAbsolute(sf::FloatRect _rel)
 
 sf::Vector2f GraphicsEngine::AbsoluteToRelative(sf::Vector2f _abs)
 {
-	sf::Vector2f rel(_abs.x + m_cameraPosition.x, _abs.y + m_cameraPosition.y);
+	sf::Vector2f rel(_abs.x - m_cameraPosition.x, _abs.y - m_cameraPosition.y);
 	return rel;
 }
 
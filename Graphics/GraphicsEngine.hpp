@@ -2,7 +2,12 @@
 #define GRAPHICSENGINE_H
 
 #include "../System/Engine.hpp"
+#include "../Graphics/DrawList.hpp"
+#include "../Graphics/FrameCapture.hpp"
+#include "../Graphics/Renderer.hpp"
 #include "../Graphics/SpriteHandler.hpp"
+#include "../System/RenderCommandBuffer.hpp"
+#include "../System/TileMap.hpp"
 
 #include <fstream>
 
@@ -18,18 +23,17 @@
 class GraphicsEngine : public Engine
 {
     public:
-        GraphicsEngine(EventEngine*);
+        GraphicsEngine(EventEngine*, RendererType _rendererType = WINDOW_RENDERER);
         ~GraphicsEngine();
 
         void Frame();
 		float GetFramerateLimit();
+		void StartCapture(const std::string& _directory, CaptureFormat _format);
+		void Close(); // End of the game: the captured frames are written and the renderer reports its stats
 
 		void RceiveLevelInfo(LevelInfo* _info);
-		void ReceiveCharacterPosition(InfoForDisplay* _info);
-
-		void RemoveDisplayableObject(unsigned int _id);
-		void UpdateForegroundItem(const InfoForDisplay *_info);
-		void DeleteForegroundItem(unsigned int _id);
+		void SetRenderCommands(RenderCommandBuffer* _renderCommands) { m_renderCommands = _renderCommands; };
+		void SetTileMap(const TileMap* _tileMap);
 
 #ifdef DEBUG_MODE
 		void StoreDebugInfo(DebugInfo *_info) { m_debugInfo = _info; };
@@ -37,41 +41,53 @@ class GraphicsEngine : public Engine
     private:
 		virtual void CreateListeners();
 
-		sf::RenderWindow *m_gameWindow;
+		Renderer *m_renderer; // A window, or a headless backend
+		FrameCapture *m_frameCapture; // NULL if the frames are not captured
+		unsigned int m_frameNumber;
 		SpriteHandler *m_spriteHandler;
 		static const float FramerateLimit;
 
 		sf::Vector2f m_levelSize;
 		sf::Vector2f m_cameraPosition;
 
-		sf::Sprite* m_tmpSprite;
 		std::string m_currentBackgroundName;
+		static const unsigned int BackgroundHandle; // Handle of the farthest background layer in m_drawList, the next ones go down from there. No DisplayableObject has them
+		std::vector<Sprite::BackgroundLayer> m_backgroundLayers;
+
+		DrawList m_drawList; // Every sprite to draw, whatever its layer
 
-		// Sprites to draw: 3 levels
-		std::vector<sf::Sprite> m_backgroundToDraw;
-		std::map<unsigned int, sf::Sprite> m_foregroundSpritesToDraw;
-		std::map<unsigned int, sf::Sprite> m_pipeSpritesToDraw;
-		std::map<unsigned int, sf::Sprite> m_displayableObjectsToDraw;
+		const TileMap* m_tileMap; // Owned by g. The tiles aren't in m_drawList: the ones in view are drawn each frame
+		std::vector<sf::Sprite> m_tileSprites; // One per tile type, only moved from one tile to the next
 
-		std::map<unsigned int, Sprite::SpriteInfo> m_spritesCurrentlyDisplayed; // Contains id of displayable object and info about the sprite currently displayed (name from RECT file)
+		RenderCommandBuffer* m_renderCommands; // Filled by g, its front buffer holds what changed during the last frame of g
+		unsigned int m_marioSpriteId;
 
-		std::map<unsigned int, InfoForDisplay*> m_animatedLevelItems;
+		std::map<unsigned int, Sprite::RenderRecord> m_renderRecords; // Retained state of each displayed object (state, clip and frame, position...)
+
+		std::vector<Sprite::AnimatedTileGroup> m_animatedTileGroups; // One per animation clip
+		std::map<unsigned int, unsigned int> m_animatedTileGroupOfItem; // Id of the level item -> index in m_animatedTileGroups
 		
-		void ResetSpritesToDraw();
+		void ApplyRenderCommands();
+		void RemoveSprite(const RenderCommand& _command);
+		void UpdateForegroundItem(const RenderCommand& _command);
 		void UpdateAnimatedLevelSprites();
-		void AddOrUpdateAnimatedLevelItem(const InfoForDisplay *_info);
+		void UpdateAnimatedTileGroup(DrawItem& _item);
+		void AnimateDisplayableObjects();
+		void RemoveFromAnimatedTileGroup(unsigned int _id);
 		void ProcessWindowEvents();
 
-		std::string GetTextureName(unsigned int _id, std::string _name, State _state);
-		void UpdateAnimationStates(unsigned int _id, std::string _stateFullName, int nbTextures);
+		void ApplyRenderCommand(const RenderCommand& _command, DrawItem& _item);
+		void SetTexture(DrawItem& _item, unsigned int _textureIndex, bool _reverse);
 
 		void DisplayWindow();
+		void CaptureFrame();
 
-		// Add sprites in m_toDraw: the farthest first
 		void SetBackgroundToDraw();
-		void SetDisplayableObjectToDraw(InfoForDisplay _info);
+		void ScrollBackground();
+		void SetDisplayableObjectToDraw(const RenderCommand& _command);
 
 		void DrawGame();
+		void DrawTiles();
 
 		void StoreLevelInfo(LevelInfo *_info);
 
@@ -79,8 +95,7 @@ class GraphicsEngine : public Engine
 		void MoveCameraOnMario(sf::FloatRect _coordsMario);
 		void MoveEverythingBy(sf::Vector2f _vect);
 
-		void ResetTmpSprite();
-	
+
 		sf::Vector2f RelativeToAbsolute(sf::Vector2f _rel);
 		sf::FloatRect RelativeToAbsolute(sf::FloatRect _rel);
 		sf::Vector2f AbsoluteToRelative(sf::Vector2f _abs);
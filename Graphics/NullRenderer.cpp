@@ -0,0 +1,62 @@
+#include <iostream>
+#include "NullRenderer.hpp"
+
+NullRenderer::NullRenderer()
+{
+	m_open = true;
+	m_stats.frames = 0;
+	m_stats.draws = 0;
+	m_stats.textureSwitches = 0;
+	m_lastTexture = NULL;
+}
+
+NullRenderer::~NullRenderer()
+{
+	Close();
+}
+
+void NullRenderer::Clear()
+{
+	m_lastTexture = NULL;
+}
+
+void NullRenderer::Draw(const sf::Sprite& _sprite)
+{
+	m_stats.draws++;
+	if (_sprite.getTexture() != m_lastTexture)
+	{
+		m_stats.textureSwitches++;
+		m_lastTexture = _sprite.getTexture();
+	}
+}
+
+void NullRenderer::Draw(const sf::Text& _text)
+{
+	// The glyphs are not laid out without a GPU, only the draw call is counted
+	m_stats.draws++;
+	m_lastTexture = NULL;
+}
+
+void NullRenderer::Display()
+{
+	m_stats.frames++;
+}
+
+void NullRenderer::Close()
+{
+	if (!m_open)
+		return;
+
+	m_open = false;
+	PrintStats();
+}
+
+void NullRenderer::PrintStats() const
+{
+	std::cout << "Null renderer: " << m_stats.frames << " frames, " << m_stats.draws << " draws, " << m_stats.textureSwitches << " texture switches" << std::endl;
+	if (m_stats.frames == 0)
+		return;
+
+	std::cout << "Per frame: " << (float)m_stats.draws / m_stats.frames << " draws, "
+		<< (float)m_stats.textureSwitches / m_stats.frames << " texture switches" << std::endl;
+}
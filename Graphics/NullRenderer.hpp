@@ -0,0 +1,42 @@
+#ifndef NULLRENDERER_H
+#define NULLRENDERER_H
+
+#include "Renderer.hpp"
+
+struct RenderStats
+{
+	unsigned int frames;
+	unsigned int draws;
+	unsigned int textureSwitches; // Each time a draw uses another texture than the previous one
+};
+
+/*
+	Headless renderer: no window and nothing sent to the GPU, the draws are only counted
+	Used to measure the CPU cost of preparing a frame, without the driver
+*/
+class NullRenderer : public Renderer
+{
+	public:
+		NullRenderer();
+		~NullRenderer();
+
+		void Clear();
+		void Draw(const sf::Sprite& _sprite);
+		void Draw(const sf::Text& _text);
+		void Display();
+
+		bool IsOpen() const { return m_open; };
+		bool PollEvent(sf::Event& _event) { return false; };
+		void Close();
+
+		const RenderStats& GetStats() const { return m_stats; };
+
+	private:
+		bool m_open;
+		RenderStats m_stats;
+		const sf::Texture* m_lastTexture;
+
+		void PrintStats() const;
+};
+
+#endif // NULLRENDERER_H
@@ -0,0 +1,37 @@
+#ifndef RENDERER_H
+#define RENDERER_H
+
+#include <SFML/Graphics.hpp>
+
+enum RendererType
+{
+	WINDOW_RENDERER,	// SFML window
+	NULL_RENDERER,		// Headless, draws are only counted
+	SOFTWARE_RENDERER	// Headless, drawn by the CPU in a framebuffer
+};
+
+/*
+	Renderer: where GraphicsEngine sends what it decided to draw. Everything before (sprite selection, animation, camera) doesn't depend on it
+*/
+class Renderer
+{
+	public:
+		virtual ~Renderer() { };
+
+		virtual bool NeedsPixels() const { return false; }; // True if the renderer draws from main memory: the textures are given with LoadTexture
+		virtual void LoadTexture(const sf::Texture& _texture, const sf::Image& _pixels) { };
+
+		virtual void Clear() = 0;
+		virtual void Draw(const sf::Sprite& _sprite) = 0;
+		virtual void Draw(const sf::Text& _text) = 0;
+		virtual void Display() = 0;
+
+		// Copies what has been drawn in the frame (RGBA). False if the renderer has no pixels
+		virtual bool CaptureFrame(std::vector<sf::Uint8>& _pixels, sf::Vector2u& _size) { return false; };
+
+		virtual bool IsOpen() const = 0;
+		virtual bool PollEvent(sf::Event& _event) = 0;
+		virtual void Close() = 0;
+};
+
+#endif // RENDERER_H
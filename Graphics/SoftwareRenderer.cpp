@@ -0,0 +1,207 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include "SoftwareRenderer.hpp"
+
+// SSE2 is always there on x64, and MSVC uses it by default on x86 too
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SOFTWARE_RENDERER_SSE2
+#include <emmintrin.h>
+#endif
+
+static const sf::Uint32 AlphaMask = 0xFF000000;
+static const sf::Uint32 OpaqueBlack = 0xFF000000;
+
+SoftwareRenderer::SoftwareRenderer(unsigned int _width, unsigned int _height)
+{
+	m_open = true;
+	m_width = _width;
+	m_height = _height;
+	m_frameBuffer.resize(_width * _height, OpaqueBlack);
+	m_nbFrames = 0;
+}
+
+SoftwareRenderer::~SoftwareRenderer()
+{
+	Close();
+}
+
+void SoftwareRenderer::LoadTexture(const sf::Texture& _texture, const sf::Image& _pixels)
+{
+	SoftwareTexture& texture = m_textures[&_texture];
+	texture.width = _pixels.getSize().x;
+	texture.height = _pixels.getSize().y;
+	texture.pixels.resize(texture.width * texture.height);
+	if (!texture.pixels.empty())
+		memcpy(&texture.pixels[0], _pixels.getPixelsPtr(), texture.pixels.size() * sizeof(sf::Uint32));
+}
+
+void SoftwareRenderer::Clear()
+{
+	m_frameClock.restart();
+	std::fill(m_frameBuffer.begin(), m_frameBuffer.end(), OpaqueBlack);
+}
+
+/*	Sprites are drawn at the nearest pixel, with an alpha test instead of blending: the sprite sheets are either opaque or fully transparent
+	A negative width in the texture rect means the sprite is reversed (see SpriteHandler::SetTextureOnSprite) */
+void SoftwareRenderer::Draw(const sf::Sprite& _sprite)
+{
+	std::map<const sf::Texture*, SoftwareTexture>::const_iterator it = m_textures.find(_sprite.getTexture());
+	if (it == m_textures.end())
+		return;
+
+	const SoftwareTexture& texture = it->second;
+	const sf::IntRect& rect = _sprite.getTextureRect();
+	int destLeft = (int)floor(_sprite.getPosition().x + 0.5f);
+	int destTop = (int)floor(_sprite.getPosition().y + 0.5f);
+	if (_sprite.getTexture()->isRepeated())
+	{
+		DrawRepeated(texture, rect, destLeft, destTop);
+		return;
+	}
+
+	bool reverse = rect.width < 0;
+	int width = std::abs(rect.width);
+	int srcLeft = reverse ? rect.left + rect.width : rect.left;
+	if (srcLeft < 0 || rect.top < 0 || srcLeft + width > (int)texture.width || rect.top + rect.height > (int)texture.height)
+		return;
+
+	// Clipping
+	int x0 = std::max(destLeft, 0);
+	int x1 = std::min(destLeft + width, (int)m_width);
+	int y0 = std::max(destTop, 0);
+	int y1 = std::min(destTop + rect.height, (int)m_height);
+	if (x0 >= x1 || y0 >= y1)
+		return;
+
+	for (int y = y0; y < y1; y++)
+	{
+		const sf::Uint32* srcRow = &texture.pixels[(rect.top + y - destTop) * texture.width];
+		sf::Uint32* destRow = &m_frameBuffer[y * m_width];
+		if (reverse)
+			BlitRowReversed(destRow + x0, srcRow + srcLeft + width - 1 - (x0 - destLeft), x1 - x0);
+		else
+			BlitRow(destRow + x0, srcRow + srcLeft + (x0 - destLeft), x1 - x0);
+	}
+}
+
+// Repeated textures (backgrounds): the texture rect can go past the texture, which wraps around. Not reversed
+void SoftwareRenderer::DrawRepeated(const SoftwareTexture& _texture, const sf::IntRect& _rect, int _destLeft, int _destTop)
+{
+	if (_texture.width == 0 || _texture.height == 0 || _rect.width <= 0)
+		return;
+
+	int x0 = std::max(_destLeft, 0);
+	int x1 = std::min(_destLeft + _rect.width, (int)m_width);
+	int y0 = std::max(_destTop, 0);
+	int y1 = std::min(_destTop + _rect.height, (int)m_height);
+	int width = _texture.width;
+	int height = _texture.height;
+
+	for (int y = y0; y < y1; y++)
+	{
+		int srcY = ((_rect.top + y - _destTop) % height + height) % height;
+		const sf::Uint32* srcRow = &_texture.pixels[srcY * width];
+		sf::Uint32* destRow = &m_frameBuffer[y * m_width];
+
+		int srcX = ((_rect.left + x0 - _destLeft) % width + width) % width;
+		for (int x = x0; x < x1; )
+		{
+			int nbPixels = std::min(x1 - x, width - srcX);
+			BlitRow(destRow + x, srcRow + srcX, nbPixels);
+			x += nbPixels;
+			srcX = 0;
+		}
+	}
+}
+
+// Source pixels with a zero alpha leave the destination unchanged
+void SoftwareRenderer::BlitRow(sf::Uint32* _dest, const sf::Uint32* _src, int _nbPixels)
+{
+	int i = 0;
+#ifdef SOFTWARE_RENDERER_SSE2
+	const __m128i alphaMask = _mm_set1_epi32((int)AlphaMask);
+	const __m128i zero = _mm_setzero_si128();
+	for (; i + 4 <= _nbPixels; i += 4)
+	{
+		__m128i src = _mm_loadu_si128(reinterpret_cast<const __m128i*>(_src + i));
+		__m128i dest = _mm_loadu_si128(reinterpret_cast<const __m128i*>(_dest + i));
+		__m128i transparent = _mm_cmpeq_epi32(_mm_and_si128(src, alphaMask), zero);
+		__m128i result = _mm_or_si128(_mm_and_si128(transparent, dest), _mm_andnot_si128(transparent, src));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(_dest + i), result);
+	}
+#endif
+	for (; i < _nbPixels; i++)
+	{
+		if (_src[i] & AlphaMask)
+			_dest[i] = _src[i];
+	}
+}
+
+// Same as BlitRow, but the source is read from right to left: _src points to the rightmost pixel to copy
+void SoftwareRenderer::BlitRowReversed(sf::Uint32* _dest, const sf::Uint32* _src, int _nbPixels)
+{
+	int i = 0;
+#ifdef SOFTWARE_RENDERER_SSE2
+	const __m128i alphaMask = _mm_set1_epi32((int)AlphaMask);
+	const __m128i zero = _mm_setzero_si128();
+	for (; i + 4 <= _nbPixels; i += 4)
+	{
+		__m128i src = _mm_loadu_si128(reinterpret_cast<const __m128i*>(_src - i - 3));
+		src = _mm_shuffle_epi32(src, _MM_SHUFFLE(0, 1, 2, 3));
+		__m128i dest = _mm_loadu_si128(reinterpret_cast<const __m128i*>(_dest + i));
+		__m128i transparent = _mm_cmpeq_epi32(_mm_and_si128(src, alphaMask), zero);
+		__m128i result = _mm_or_si128(_mm_and_si128(transparent, dest), _mm_andnot_si128(transparent, src));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(_dest + i), result);
+	}
+#endif
+	for (; i < _nbPixels; i++)
+	{
+		if (_src[-i] & AlphaMask)
+			_dest[i] = _src[-i];
+	}
+}
+
+void SoftwareRenderer::Display()
+{
+	sf::Time frameTime = m_frameClock.getElapsedTime();
+	m_drawTime += frameTime;
+	m_worstFrameTime = std::max(m_worstFrameTime, frameTime);
+	m_nbFrames++;
+}
+
+void SoftwareRenderer::Close()
+{
+	if (!m_open)
+		return;
+
+	m_open = false;
+	PrintStats();
+}
+
+/* Only the drawing is measured: the time gfx spends choosing what to draw is in the summary of Game::Run */
+void SoftwareRenderer::PrintStats() const
+{
+	std::cout << "Software renderer: " << m_nbFrames << " frames at " << m_width << "x" << m_height << ", " << m_drawTime.asMilliseconds() << " ms drawing" << std::endl;
+	if (m_nbFrames == 0)
+		return;
+
+	sf::Int64 averageFrameTime = m_drawTime.asMicroseconds() / m_nbFrames;
+	std::cout << "Per frame: " << averageFrameTime << " us drawing (worst " << m_worstFrameTime.asMicroseconds() << " us), "
+		<< (averageFrameTime > 0 ? 1000000 / averageFrameTime : 0) << " frames per second at most" << std::endl;
+}
+
+bool SoftwareRenderer::CaptureFrame(std::vector<sf::Uint8>& _pixels, sf::Vector2u& _size)
+{
+	_size = GetSize();
+	_pixels.assign(GetPixels(), GetPixels() + m_frameBuffer.size() * sizeof(sf::Uint32));
+	return true;
+}
+
+bool SoftwareRenderer::SaveToFile(const std::string& _fileName) const
+{
+	sf::Image image;
+	image.create(m_width, m_height, GetPixels());
+	return image.saveToFile(_fileName);
+}
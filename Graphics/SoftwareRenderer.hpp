@@ -0,0 +1,63 @@
+#ifndef SOFTWARERENDERER_H
+#define SOFTWARERENDERER_H
+
+#include <map>
+#include <vector>
+#include "Renderer.hpp"
+
+/*
+	Headless renderer that draws the sprites with the CPU in an RGBA framebuffer, the same way the window would show them
+	Used to compare frames with reference images and to render replays on machines without a GPU
+*/
+class SoftwareRenderer : public Renderer
+{
+	public:
+		SoftwareRenderer(unsigned int _width, unsigned int _height);
+		~SoftwareRenderer();
+
+		bool NeedsPixels() const { return true; };
+		void LoadTexture(const sf::Texture& _texture, const sf::Image& _pixels);
+
+		void Clear();
+		void Draw(const sf::Sprite& _sprite);
+		void Draw(const sf::Text& _text) { }; // No font rasterizer: the debug text is not drawn
+		void Display();
+		bool CaptureFrame(std::vector<sf::Uint8>& _pixels, sf::Vector2u& _size);
+
+		bool IsOpen() const { return m_open; };
+		bool PollEvent(sf::Event& _event) { return false; };
+		void Close();
+
+		const sf::Uint8* GetPixels() const { return reinterpret_cast<const sf::Uint8*>(&m_frameBuffer[0]); }; // RGBA, row by row
+		sf::Vector2u GetSize() const { return sf::Vector2u(m_width, m_height); };
+		bool SaveToFile(const std::string& _fileName) const;
+
+	private:
+		struct SoftwareTexture
+		{
+			unsigned int width;
+			unsigned int height;
+			std::vector<sf::Uint32> pixels; // RGBA bytes, read 4 at a time (alpha is the high byte on x86)
+		};
+
+		bool m_open;
+		unsigned int m_width;
+		unsigned int m_height;
+		std::vector<sf::Uint32> m_frameBuffer;
+		std::map<const sf::Texture*, SoftwareTexture> m_textures;
+
+		// Time spent drawing, from Clear to Display
+		sf::Clock m_frameClock;
+		sf::Time m_drawTime;
+		sf::Time m_worstFrameTime;
+		unsigned int m_nbFrames;
+
+		void PrintStats() const;
+
+		void DrawRepeated(const SoftwareTexture& _texture, const sf::IntRect& _rect, int _destLeft, int _destTop);
+
+		static void BlitRow(sf::Uint32* _dest, const sf::Uint32* _src, int _nbPixels);
+		static void BlitRowReversed(sf::Uint32* _dest, const sf::Uint32* _src, int _nbPixels);
+};
+
+#endif // SOFTWARERENDERER_H
@@ -3,162 +3,239 @@
 */
 #include <exception>
 #include "../System/DisplayableObject.hpp"
+#include "../System/SpriteRegistry.hpp"
 #include "GraphicsEngine.hpp"
 #include "SpriteHandler.hpp"
 
 const int SpriteHandler::FramesBetweenAnimationChanges = 7;
 const std::string SpriteHandler::texturesPath = Util::GetAssetsPath() +  "sprites/";
 
-SpriteHandler::SpriteHandler()
+SpriteHandler::SpriteHandler(bool _uploadTextures, bool _keepPixels)
 {
-
+	m_uploadTextures = _uploadTextures;
+	m_keepPixels = _keepPixels;
 }
 
 void SpriteHandler::LoadTextures()
 {
-	LoadTexturesFromFile("background");
-	LoadTexturesFromFile("floor");
-	LoadTexturesFromFile("mario");
-	LoadTexturesFromFile("goomba");
-	LoadTexturesFromFile("item");
+	const std::vector<std::string>& sheets = Util::GetSpriteSheetNames();
+	for (unsigned int i = 0; i < sheets.size(); i++)
+		LoadTexturesFromFile(sheets[i]);
+	LoadBackgroundLayers();
 }
 
-void SpriteHandler::LoadTexturesFromFile(std::string _fileName)
+void SpriteHandler::LoadBackgroundLayers()
 {
-	/* Each line looks like "state 00 00 00 00 " with the numbers being left top right bottom */
+	/* Each line looks like "background state 0.5 0" with state being in background.rect and the numbers the horizontal and vertical parallax factors */
 	std::string buffer;
 	std::vector<std::string> splittedBuffer;
-	std::string tmpStateName;
-	sf::IntRect tmpCoordinates;
-
-	std::string imgFileName = SpriteHandler::texturesPath + _fileName + ".png";
-	std::string rectFileName = SpriteHandler::texturesPath + _fileName + ".rect";
 
-	std::ifstream rectFile;
-	rectFile.open(rectFileName);
+	std::ifstream layersFile;
+	layersFile.open(SpriteHandler::texturesPath + "background.layers");
 
-	while (getline(rectFile, buffer))
+	while (getline(layersFile, buffer))
 	{
 		if (buffer == "")
 			continue;
 
 		splittedBuffer = Util::Split(buffer, ' ');
+		if (splittedBuffer.size() != 4)
+		{
+			std::cerr << "Error: wrong number of items in background.layers: " << buffer << std::endl;
+			continue;
+		}
 
-		if (splittedBuffer.size() != 5)
+		std::map<std::string, unsigned int>::iterator texture = m_textureIndexes.find("background_" + splittedBuffer[1]);
+		if (texture == m_textureIndexes.end())
 		{
-			std::cerr << "Error: wrong number of items for state " << tmpStateName << " in file " << _fileName << ".rect" << std::endl;
+			std::cerr << "Error: no texture " << splittedBuffer[1] << " in background.rect for background " << splittedBuffer[0] << std::endl;
 			continue;
 		}
 
 		try
 		{
-			tmpStateName = splittedBuffer[0];
-			tmpCoordinates.left = std::stoi(splittedBuffer[1]);
-			tmpCoordinates.top = std::stoi(splittedBuffer[2]);
-			tmpCoordinates.width = std::stoi(splittedBuffer[3]) - tmpCoordinates.left;
-			tmpCoordinates.height = std::stoi(splittedBuffer[4]) - tmpCoordinates.top;
-			m_textures[_fileName + "_" + tmpStateName].loadFromFile(SpriteHandler::texturesPath + _fileName + ".png", tmpCoordinates);
+			Sprite::BackgroundLayer layer;
+			layer.textureIndex = texture->second;
+			layer.parallax.x = std::stof(splittedBuffer[2]);
+			layer.parallax.y = std::stof(splittedBuffer[3]);
+			SetRepeated(layer.textureIndex);
+			m_backgroundLayers[splittedBuffer[0]].push_back(layer);
 		}
-		catch (std::invalid_argument err)
+		catch (const std::invalid_argument& err)
 		{
-			std::cerr << "Error trying to parse state " << tmpStateName << " in file " << _fileName << ".rect: " << err.what() << std::endl;
+			std::cerr << "Error trying to parse background layer " << buffer << ": " << err.what() << std::endl;
 		}
 	}
 
-	rectFile.close();
+	layersFile.close();
 }
 
-sf::Texture& SpriteHandler::GetTexture(std::string _name)
+/* A background that is not in background.layers is the texture with the same name, fixed */
+const std::vector<Sprite::BackgroundLayer>& SpriteHandler::GetBackgroundLayers(const std::string& _backgroundName)
 {
-	return m_textures[_name];
+	std::map<std::string, std::vector<Sprite::BackgroundLayer> >::iterator it = m_backgroundLayers.find(_backgroundName);
+	if (it != m_backgroundLayers.end())
+		return it->second;
+
+	std::vector<Sprite::BackgroundLayer>& layers = m_backgroundLayers[_backgroundName];
+	std::map<std::string, unsigned int>::iterator texture = m_textureIndexes.find("background_" + _backgroundName);
+	if (texture != m_textureIndexes.end())
+	{
+		Sprite::BackgroundLayer layer;
+		layer.textureIndex = texture->second;
+		layer.parallax = sf::Vector2f(0, 0);
+		SetRepeated(layer.textureIndex);
+		layers.push_back(layer);
+	}
+	return layers;
 }
 
-void SpriteHandler::SetDisplayInfoOnSprite(InfoForDisplay _info, sf::Sprite *_sprite)
+void SpriteHandler::LoadTexturesFromFile(std::string _fileName)
 {
-	_sprite->setTexture(m_textures[_info.name]);
-	_sprite->setPosition(sf::Vector2f(_info.coordinates.left, _info.coordinates.top));
+	// The sheet is decoded once, each state is then a part of it
+	sf::Image sheet;
+	if (m_uploadTextures || m_keepPixels)
+		sheet.loadFromFile(SpriteHandler::texturesPath + _fileName + ".png");
 
-	if (_info.reverse)
+	std::vector<SpriteRect> rects = Util::ReadRectFile(_fileName);
+	for (unsigned int i = 0; i < rects.size(); i++)
 	{
-		float height = _sprite->getGlobalBounds().height;
-		float width = _sprite->getGlobalBounds().width;
-		_sprite->setTextureRect(sf::IntRect(width, 0, -width, height));
+		const std::string& textureName = rects[i].name;
+		const sf::IntRect& rect = rects[i].rect;
+		if (m_uploadTextures)
+			m_textures[textureName].loadFromImage(sheet, rect);
+		if (m_textureIndexes.find(textureName) == m_textureIndexes.end())
+		{
+			m_textureIndexes[textureName] = m_texturesByIndex.size();
+			m_texturesByIndex.push_back(&m_textures[textureName]); // Pointers to map elements stay valid
+			m_textureSizes.push_back(sf::Vector2i());
+			m_pixels.push_back(sf::Image());
+		}
+
+		unsigned int index = m_textureIndexes[textureName];
+		m_textureSizes[index] = sf::Vector2i(rect.width, rect.height);
+		if (m_keepPixels)
+		{
+			m_pixels[index].create(rect.width, rect.height, sf::Color::Transparent);
+			m_pixels[index].copy(sheet, 0, 0, rect);
+		}
 	}
 }
 
-void SpriteHandler::SetTextureOnSprite(std::string _textureName, sf::Sprite *_sprite)
+sf::Texture& SpriteHandler::GetTexture(std::string _name)
 {
-	_sprite->setTexture(m_textures[_textureName]);
+	return m_textures[_name];
 }
 
-/* Figures out which sprite to display, ie the name of the sprite in the RECT file */
-std::string SpriteHandler::GetFullStateName(std::string _name, State _state)
+/*	The texture rect is always set because sprites are kept from one frame to the next, and the previous texture might be reversed or of another size
+	It comes from the .rect file rather than from the texture, which is empty when headless */
+void SpriteHandler::SetTextureOnSprite(unsigned int _textureIndex, bool _reverse, sf::Sprite *_sprite)
 {
-	switch (_state)
-	{
-		case STATIC:
-			return _name + "_static";
-		case RUN:
-		case WALK:
-			return _name + "_walk";
-		case JUMP:
-			return _name + "_jump";
-		case FALL:
-			return _name + "_fall";
-		case EMPTY:
-			return _name + "_empty";
-		case UNKNOWN:
-		case NORMAL:
-			return _name;
-		default:
-			assert(false);
-			return NULL;
-	}
+	_sprite->setTexture(*m_texturesByIndex[_textureIndex]);
+
+	const sf::Vector2i& size = m_textureSizes[_textureIndex];
+	if (_reverse)
+		_sprite->setTextureRect(sf::IntRect(size.x, 0, -size.x, size.y));
+	else
+		_sprite->setTextureRect(sf::IntRect(0, 0, size.x, size.y));
 }
 
-std::string SpriteHandler::GetTextureNameFromStateName(std::string _stateFullName, Sprite::SpriteInfo& _currentInfo, int _nbTextures)
+void SpriteHandler::SetTextureOnSprite(std::string _textureName, sf::Sprite *_sprite)
+{
+	std::map<std::string, unsigned int>::iterator it = m_textureIndexes.find(_textureName);
+	if (it != m_textureIndexes.end())
+		SetTextureOnSprite(it->second, false, _sprite);
+}
+
+/* Resolves the name of an entity to its row in the animation table. String work is done here only, the first time the entity is met */
+int SpriteHandler::GetEntityType(unsigned int _spriteId)
 {
-	return _nbTextures == 1 ? _stateFullName : FindNextTextureName(_stateFullName, _currentInfo, _nbTextures);
+	if (_spriteId >= m_entityTypeOfSprite.size())
+		m_entityTypeOfSprite.resize(_spriteId + 1, -1);
+	if (m_entityTypeOfSprite[_spriteId] != -1)
+		return m_entityTypeOfSprite[_spriteId];
+
+	Sprite::EntityAnimations entity;
+	entity.name = SpriteRegistry::GetName(_spriteId);
+	for (int state = 0; state < Sprite::NbStates; state++)
+		entity.clipOfState[state] = CompileAnimationClip(Util::GetFullStateName(entity.name, (State)state));
+
+	m_animationTable.push_back(entity);
+	m_entityTypeOfSprite[_spriteId] = m_animationTable.size() - 1;
+	return m_animationTable.size() - 1;
 }
 
-int SpriteHandler::HowManyLoadedTexturesContainThisName(std::string _stateName)
+/* Finds the textures of a state: either exactly _stateFullName (static), or _stateFullName + "1", "2"... (animation). Returns -1 if there is none */
+int SpriteHandler::CompileAnimationClip(const std::string& _stateFullName)
 {
-	// Counts the number of textures that are either exactly _stateName (static), or smth like _stateName + "2" (animation)
-	int nb = 0;
-	std::string frameNumber;
-	for (std::map<std::string, sf::Texture>::iterator it = m_textures.begin(); it != m_textures.end(); ++it)
+	std::map<std::string, int>::iterator it = m_clipIndexes.find(_stateFullName);
+	if (it != m_clipIndexes.end())
+		return it->second;
+
+	Sprite::AnimationClip clip;
+	std::map<std::string, unsigned int>::iterator texture = m_textureIndexes.find(_stateFullName);
+	if (texture != m_textureIndexes.end())
+		clip.frames.push_back(texture->second);
+	else
 	{
-		if (it->first.length() < _stateName.length()) // State name longer than texture name: the texture can't be right
-			continue;
+		for (int frame = 1; (texture = m_textureIndexes.find(_stateFullName + std::to_string(frame))) != m_textureIndexes.end(); frame++)
+			clip.frames.push_back(texture->second);
 
-		if (it->first == _stateName)
-			return 1; // Found the exact name, ie a static sprite
+		if (clip.frames.size() == 1) // There is a "walk1" but no "walk2": this would be an animation with only 1 sprite, which is a problem
+			clip.frames.clear();
+	}
 
-		frameNumber = it->first.substr(_stateName.length());
-		if (it->first.compare(0, _stateName.length(), _stateName) == 0 && Util::isInteger(frameNumber))
-			nb++; // Found the name followed by a number, ie a frame of an animation
+	int clipIndex = -1;
+	if (!clip.frames.empty())
+	{
+		m_clips.push_back(clip);
+		clipIndex = m_clips.size() - 1;
 	}
-	return nb == 1 ? 0 : nb; // nb == 1 here means that _stateName == "walk" and there is no "walk" in the map, but rather a "walk1", and this is a problem (this would be an animation with only 1 sprite)
+	m_clipIndexes[_stateFullName] = clipIndex;
+	return clipIndex;
 }
 
-std::string SpriteHandler::FindNextTextureName(std::string _stateName, Sprite::SpriteInfo& _currentInfo, int _nbTextures)
+/* Picks the clip to play for this state. The animation starts over only if the clip changed (walking and running share the same one, for example) */
+void SpriteHandler::SetState(Sprite::SpriteInfo& _currentInfo, State _state)
 {
-	if (_currentInfo.name == "" || _currentInfo.name.find(_stateName) == std::string::npos) // If it's the first time we are displaying this id OR if we are beginning the animation
-		return _stateName + "1";
-
-	if (HowManyLoadedTexturesContainThisName(_stateName) <= 1)
+	int clipIndex = m_animationTable[_currentInfo.entityType].clipOfState[_state];
+	if (clipIndex < 0)
 	{
-		std::cerr << HowManyLoadedTexturesContainThisName(_stateName) << " texture contain " << _stateName << std::endl;
+		std::cerr << "ERROR: no texture for state \"" << _state << "\" of \"" << m_animationTable[_currentInfo.entityType].name << "\"" << std::endl;
 		assert(false);
+		return;
+	}
+
+	if (clipIndex != _currentInfo.clip)
+	{
+		_currentInfo.clip = clipIndex;
+		_currentInfo.frame = 0;
+		_currentInfo.framesSinceLastChange = 0;
 	}
+}
+
+/* Moves the animation forward by one frame of the game. Returns true if the sprite to display changed */
+bool SpriteHandler::Animate(Sprite::SpriteInfo& _currentInfo)
+{
+	if (!IsAnimated(_currentInfo))
+		return false;
 
-	// We are now ready to display the next sprite of the animation but we can't display a new sprite at every frame, that's too fast. So we use FramesBetweenAnimationChanges.
+	// We can't display a new sprite at every frame, that's too fast. So we use FramesBetweenAnimationChanges.
 	_currentInfo.framesSinceLastChange++;
 	if (_currentInfo.framesSinceLastChange % SpriteHandler::FramesBetweenAnimationChanges != 0)
-		return _currentInfo.name;
-	else
-		_currentInfo.framesSinceLastChange = 0;
+		return false;
 
-	int nbCurrentFrame = std::stoi(_currentInfo.name.substr(_stateName.length())); // currentTextureName is like mario_walk2 and _stateName is like mario_walk ==> we get the 2
-	return _stateName + (nbCurrentFrame == _nbTextures ? "1" : std::to_string(++nbCurrentFrame));
+	_currentInfo.framesSinceLastChange = 0;
+	_currentInfo.frame = (_currentInfo.frame + 1) % m_clips[_currentInfo.clip].frames.size();
+	return true;
+}
+
+unsigned int SpriteHandler::GetCurrentTextureIndex(const Sprite::SpriteInfo& _currentInfo) const
+{
+	return _currentInfo.clip >= 0 ? m_clips[_currentInfo.clip].frames[_currentInfo.frame] : 0;
+}
+
+bool SpriteHandler::IsAnimated(const Sprite::SpriteInfo& _currentInfo) const
+{
+	return _currentInfo.clip >= 0 && m_clips[_currentInfo.clip].frames.size() > 1;
 }
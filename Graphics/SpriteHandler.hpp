@@ -11,27 +11,49 @@ SpriteHandler: All operations from retrieving the textures to deciding which spr
 class SpriteHandler
 {
 	public:
-		SpriteHandler();
+		SpriteHandler(bool _uploadTextures = true, bool _keepPixels = false);
 
 		void LoadTextures(); // Load all textures at beginning of level
 		sf::Texture& GetTexture(std::string _name);
+		const sf::Texture& GetTexture(unsigned int _textureIndex) const { return *m_texturesByIndex[_textureIndex]; };
+		void SetRepeated(unsigned int _textureIndex) { m_texturesByIndex[_textureIndex]->setRepeated(true); };
+		const std::vector<Sprite::BackgroundLayer>& GetBackgroundLayers(const std::string& _backgroundName);
+		const sf::Image& GetPixels(unsigned int _textureIndex) const { return m_pixels[_textureIndex]; };
+		unsigned int GetNbTextures() const { return m_texturesByIndex.size(); };
 
-		void SetDisplayInfoOnSprite(InfoForDisplay _info, sf::Sprite *_sprite);
-		void SpriteHandler::SetTextureOnSprite(std::string _textureName, sf::Sprite *_sprite);
+		void SetTextureOnSprite(unsigned int _textureIndex, bool _reverse, sf::Sprite *_sprite);
+		void SetTextureOnSprite(std::string _textureName, sf::Sprite *_sprite);
 
-		std::string GetFullStateName(std::string _name, State _state);
-		std::string GetTextureNameFromStateName(std::string _stateFullName, Sprite::SpriteInfo& _currentInfo, int _nbTextures);
-		int HowManyLoadedTexturesContainThisName(std::string _name);
+		int GetEntityType(unsigned int _spriteId);
+		void SetState(Sprite::SpriteInfo& _currentInfo, State _state);
+		bool Animate(Sprite::SpriteInfo& _currentInfo);
+		unsigned int GetCurrentTextureIndex(const Sprite::SpriteInfo& _currentInfo) const;
+		bool IsAnimated(const Sprite::SpriteInfo& _currentInfo) const;
 
 		static const int FramesBetweenAnimationChanges;
 		static const std::string texturesPath;
 
 	private:
 		std::map<std::string, sf::Texture> m_textures;
+		std::vector<sf::Texture*> m_texturesByIndex; // Index given at loading time, this is what the animation clips refer to
+		std::map<std::string, unsigned int> m_textureIndexes;
+		std::vector<sf::Vector2i> m_textureSizes; // Read from the .rect files, so the sprites have the right size even when nothing is uploaded
+		bool m_uploadTextures; // False when headless: there is no GPU to send the textures to
+		bool m_keepPixels; // For the software renderer, which draws from main memory
+		std::vector<sf::Image> m_pixels; // Same indexes as m_texturesByIndex, empty if !m_keepPixels
+
+		// Animation table: compiled the first time an entity is met, so that choosing a sprite is only a couple of array lookups
+		std::vector<int> m_entityTypeOfSprite; // Sprite id (see SpriteRegistry) -> index in m_animationTable, -1 if not compiled yet
+		std::vector<Sprite::EntityAnimations> m_animationTable;
+		std::map<std::string, int> m_clipIndexes; // Full state name (e.g. "mario_walk") -> index in m_clips
+		std::vector<Sprite::AnimationClip> m_clips;
+
+		std::map<std::string, std::vector<Sprite::BackgroundLayer> > m_backgroundLayers; // Farthest layer first
 
 		void LoadTexturesFromFile(std::string _fileName);
+		void LoadBackgroundLayers();
 
-		std::string FindNextTextureName(std::string _stateName, Sprite::SpriteInfo& _currentInfo, int _nbTextures);
+		int CompileAnimationClip(const std::string& _stateFullName);
 };
 
 #endif
@@ -0,0 +1,21 @@
+#include "WindowRenderer.hpp"
+
+WindowRenderer::WindowRenderer(unsigned int _width, unsigned int _height, const std::string& _title)
+{
+	m_window = new sf::RenderWindow(sf::VideoMode(_width, _height, 32), _title, sf::Style::Titlebar | sf::Style::Close);
+}
+
+// Reading back from the GPU waits for it to finish the frame: only the copy is done here, the encoding is left to FrameCapture
+bool WindowRenderer::CaptureFrame(std::vector<sf::Uint8>& _pixels, sf::Vector2u& _size)
+{
+	sf::Image image = m_window->capture();
+	_size = image.getSize();
+	_pixels.assign(image.getPixelsPtr(), image.getPixelsPtr() + _size.x * _size.y * 4);
+	return true;
+}
+
+WindowRenderer::~WindowRenderer()
+{
+	m_window->close();
+	delete m_window;
+}
@@ -0,0 +1,29 @@
+#ifndef WINDOWRENDERER_H
+#define WINDOWRENDERER_H
+
+#include "Renderer.hpp"
+
+/*
+	Draws in an SFML window
+*/
+class WindowRenderer : public Renderer
+{
+	public:
+		WindowRenderer(unsigned int _width, unsigned int _height, const std::string& _title);
+		~WindowRenderer();
+
+		void Clear() { m_window->clear(); };
+		void Draw(const sf::Sprite& _sprite) { m_window->draw(_sprite); };
+		void Draw(const sf::Text& _text) { m_window->draw(_text); };
+		void Display() { m_window->display(); };
+		bool CaptureFrame(std::vector<sf::Uint8>& _pixels, sf::Vector2u& _size);
+
+		bool IsOpen() const { return m_window->isOpen(); };
+		bool PollEvent(sf::Event& _event) { return m_window->pollEvent(_event); };
+		void Close() { m_window->close(); };
+
+	private:
+		sf::RenderWindow *m_window;
+};
+
+#endif // WINDOWRENDERER_H
@@ -1,4 +1,5 @@
 #include "SoundEngine.hpp"
+#include "../System/AllocationTripwire.hpp"
 #include "../System/Listener/CharacterDiedListener.hpp"
 #include "../System/Listener/MarioJumpListener.hpp"
 #include "../System/Listener/MarioKickedEnemyListener.hpp"
@@ -8,7 +9,7 @@ const std::string SoundEngine::soundsPath = Util::GetAssetsPath() + "sounds/";
 
 SoundEngine::SoundEngine(EventEngine* _eventEngine) : Engine(_eventEngine), m_indexCurrentMusic(-1)
 {
-	m_soundBeingPlayed = new sf::Sound();
+	m_soundBeingPlayed = NULL;
 	m_currentMusic = new sf::Music();
 	LoadSounds();
 	StoreMusicNames();
@@ -37,7 +38,6 @@ void SoundEngine::CreateListeners()
 
 SoundEngine::~SoundEngine()
 {
-	delete m_soundBeingPlayed;
 	delete m_currentMusic;
 
 	for (unsigned int i = 0; i < m_createdListeners.size(); i++)
@@ -72,7 +72,10 @@ void SoundEngine::LoadSoundFromFile(SoundType _type, std::string _fileName)
 	if (!buffer.loadFromFile(soundFullName))
 		std::cerr << "Can't load sound " << soundFullName << std::endl;
 	else
+	{
 		m_soundBuffers[_type] = buffer;
+		m_sounds[_type].setBuffer(m_soundBuffers[_type]);
+	}
 }
 
 void SoundEngine::PlaySound(SoundType _type)
@@ -88,7 +91,9 @@ void SoundEngine::PlaySound(SoundType _type)
 		m_eventEngine->dispatch("game.toggle_ignore_input", &deathSoundPlaying);
 	}
 
-	m_soundBeingPlayed->setBuffer(m_soundBuffers[_type]); // Could optimize this by remembering the last buffer set
+	if (m_soundBeingPlayed != NULL)
+		m_soundBeingPlayed->stop();
+	m_soundBeingPlayed = &m_sounds[_type];
 	m_soundBeingPlayed->play();
 }
 
@@ -112,6 +117,7 @@ void SoundEngine::ChangeMusic()
 
 void SoundEngine::PlayMusic(std::string _musicName)
 {
+	AllocationTripwire::ExpectedAllocations expectedAllocations; // Opening the file
 	std::string musicFullName = SoundEngine::soundsPath + _musicName;
 	if (!m_currentMusic->openFromFile(musicFullName))
 		std::cerr << "Can't open music file " << musicFullName << std::endl;
@@ -23,7 +23,8 @@ class SoundEngine : public Engine
 		virtual void CreateListeners();
 
 		std::map<SoundType, sf::SoundBuffer> m_soundBuffers;
-		sf::Sound *m_soundBeingPlayed;
+		std::map<SoundType, sf::Sound> m_sounds; // One per buffer, bound once: binding a buffer when playing allocates in SFML
+		sf::Sound *m_soundBeingPlayed; // One of m_sounds, only one sound is played at a time
 		bool m_deathSoundIsPlaying; // This sound is particular because it stops the music and no input is possible while it's playing
 
 		std::vector<std::string> m_musicNames;
@@ -1,15 +1,20 @@
 #include "Game.hpp"
+#include "../System/AllocationTripwire.hpp"
+#include "../System/FrameArena.hpp"
 #include "../System/Listener/CloseRequestListener.hpp"
 
-Game::Game()
+Game::Game(RendererType _rendererType, unsigned int _nbFramesToRun)
 {
     m_running = true;
+    m_headless = (_rendererType != WINDOW_RENDERER);
+    m_nbFramesToRun = _nbFramesToRun;
+    m_nbAllocatingFrames = 0;
 
     m_eventEngine = new EventEngine();
 
     // Creating engines
     m_g = new GameEngine (m_eventEngine);
-    m_gfx = new GraphicsEngine (m_eventEngine);
+    m_gfx = new GraphicsEngine (m_eventEngine, _rendererType);
     m_s = new SoundEngine (m_eventEngine);
 
     CloseRequestListener* closeRequestListener = new CloseRequestListener(this);
@@ -37,27 +42,57 @@ Game::~Game()
 	delete m_eventEngine;
 }
 
-void Game::Run()
+bool Game::Run()
 {
 	bool running = m_running;
 	sf::Clock clock;
+	unsigned int nbFrames = 0;
+	sf::Time gfxTime; // Time spent preparing the frames in gfx: what is measured when headless
 
 	while (running)
 	{
-		m_g->Frame(clock.getElapsedTime().asSeconds());
+		AllocationTripwire::StartFrame();
+
+		// Headless runs must give the same frames on every machine: fixed time step
+		m_g->Frame(m_headless ? 1 / m_gfx->GetFramerateLimit() : clock.getElapsedTime().asSeconds());
 		clock.restart();
 		m_gfx->Frame();
+		gfxTime += clock.getElapsedTime();
+		if (nbFrames == 0)
+			std::cout << "First frame drawn " << m_startClock.getElapsedTime().asMilliseconds() << " ms after the start of the game" << std::endl;
         m_s->Frame();
 
         m_running_mutex.lock();
         running = m_running;
         m_running_mutex.unlock();
 
+		FrameArena::Get().Reset(); // Before the tripwire: a frame that overflowed the arena grows it, and must be seen
+		if (!AllocationTripwire::EndFrame(nbFrames))
+			m_nbAllocatingFrames++;
+		if (m_g->IsLevelStarted())
+			AllocationTripwire::Arm(); // From the frame after the one that loaded the level
+
+		nbFrames++;
+		if (m_nbFramesToRun != 0 && nbFrames >= m_nbFramesToRun)
+			running = false;
+
+		if (m_headless)
+			continue;
+
 		// Enforce the framerateLimit (doesn't take into account the time spent in m_g->Frame; could be improved with a second clock)
 		float framerateLimit = m_gfx->GetFramerateLimit();
 		while (clock.getElapsedTime().asSeconds() < 1 / framerateLimit)
 			sf::sleep(sf::seconds( (1.f / framerateLimit - clock.getElapsedTime().asSeconds()) / 2.f));
 	}
+
+	if (nbFrames != 0)
+		std::cout << "gfx: " << gfxTime.asMicroseconds() / nbFrames << " us per frame over " << nbFrames << " frames" << std::endl;
+	std::cout << "frame arena: " << FrameArena::Get().GetHighWaterMark() << " bytes at most in a frame, capacity " << FrameArena::Get().GetCapacity()
+		<< " (" << FrameArena::Get().GetNbOverflows() << " frames overflowed)" << std::endl;
+	if (m_nbAllocatingFrames != 0)
+		std::cerr << "Allocation tripwire: " << m_nbAllocatingFrames << " frames allocated without expecting it" << std::endl;
+	m_gfx->Close();
+	return m_nbAllocatingFrames == 0;
 }
 
 void Game::Stop()
@@ -17,15 +17,25 @@
 class Game
 {
     public:
-        Game ();
+        Game (RendererType _rendererType = WINDOW_RENDERER, unsigned int _nbFramesToRun = 0);
         ~Game();
 
-        void Run();
+        bool Run(); // False if a check of the run failed (--allocation-tripwire)
+        void StartCapture(const std::string& _directory, CaptureFormat _format) { m_gfx->StartCapture(_directory, _format); };
+        void SetLevelStreaming(bool _streaming) { m_g->SetLevelStreaming(_streaming); };
+        void SetCompiledLevels(bool _useCompiledLevels) { m_g->SetCompiledLevels(_useCompiledLevels); };
+        void SetWriteCompiledLevels(bool _writeCompiledLevels) { m_g->SetWriteCompiledLevels(_writeCompiledLevels); };
+        void SetLevels(const std::vector<std::string>& _lvlNames) { m_g->SetLevels(_lvlNames); };
+        void SetHotReload(bool _hotReload) { m_g->SetHotReload(_hotReload); };
         void Stop();
 
     private:
         bool m_running;
+        bool m_headless; // No window: frames run as fast as possible, with a fixed time step
+        unsigned int m_nbFramesToRun; // 0: until the window is closed
+        unsigned int m_nbAllocatingFrames; // Failures of AllocationTripwire
         std::mutex m_running_mutex;
+        sf::Clock m_startClock; // Since the creation of the game, for the time to the first frame
 
         GameEngine *m_g;
         GraphicsEngine *m_gfx;
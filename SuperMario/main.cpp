@@ -3,15 +3,148 @@
     Created on 21/03/15 by Kevin Guillaumond after PSE-Mario school project with Nicolas Djambazian
     Architecture inspired by http://khayyam.developpez.com/articles/cpp/jeux/architecture/
     main.cpp: Creates the Game object and launches the game
+    Options: --headless (no window, draws are only counted), --software (no window, drawn by the CPU) --frames N (stop after N frames)
+        and --capture DIRECTORY [png|raw] (write every frame in DIRECTORY, png by default)
+        --stream (the level is read from the disk by sections, as Mario moves), --xml-levels (compiled levels are ignored)
+        --write-compiled-levels (a level read from its XML file is compiled to levels/NAME.lvl for the next time, nothing is written otherwise)
+        --levels NAME,NAME... (played in this order, each one starts when Mario reaches the right edge of the previous one)
+        --hot-reload (what changes in the file of the current level is applied to it while it's played)
+        --scenario NAME (a benchmark level of LevelGenerator, generated then played, e.g. --headless --frames 1000 --scenario stress_dense)
+        --allocation-tripwire (a frame of a started level that allocates without expecting it is reported, and the game exits with 1, see AllocationTripwire)
+    Tools: --compile-level NAME (levels/NAME.xml -> levels/NAME.lvl), --benchmark-level NAME [N] (N loads from each file, 20 by default)
+        and --benchmark-xml FILE [N] (N reads of an XML file by each reader, 5 by default), --generate-scenarios (every benchmark level of LevelGenerator)
 */
 
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
 #include <thread>
+#include <vector>
 #include "Game.hpp"
+#include "../Game/LevelCompiler.hpp"
+#include "../Game/LevelGenerator.hpp"
+#include "../System/AllocationTripwire.hpp"
+
+static void PrintUsage(const char* _program)
+{
+    std::cerr << "Usage: " << _program << " [--headless | --software] [--frames N] [--capture DIRECTORY [png|raw]] [--stream] [--xml-levels] [--write-compiled-levels]"
+        << " [--levels NAME,NAME...] [--hot-reload] [--scenario NAME] [--allocation-tripwire] | --compile-level NAME | --benchmark-level NAME [N] | --benchmark-xml FILE [N]"
+        << " | --generate-scenarios" << std::endl;
+}
+
+/* False if _text is not a number greater than 0, with nothing after it */
+static bool ReadCount(const char* _text, unsigned int& _count)
+{
+    try
+    {
+        std::size_t end;
+        int count = std::stoi(_text, &end);
+        if (_text[end] != '\0' || count <= 0)
+            return false;
+        _count = count;
+        return true;
+    }
+    catch (const std::logic_error&) // invalid_argument or out_of_range
+    {
+        return false;
+    }
+}
 
 int main(int argc, char** argv)
 {
-    Game* g = new Game();
-	g->Run();
+    RendererType rendererType = WINDOW_RENDERER;
+    unsigned int nbFrames = 0;
+    std::string captureDirectory;
+    CaptureFormat captureFormat = CAPTURE_PNG;
+    bool streamLevels = false;
+    bool compiledLevels = true;
+    bool writeCompiledLevels = false;
+    bool hotReload = false;
+    std::vector<std::string> levels;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--headless") == 0)
+            rendererType = NULL_RENDERER;
+        else if (strcmp(argv[i], "--software") == 0)
+            rendererType = SOFTWARE_RENDERER;
+        else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+        {
+            if (!ReadCount(argv[++i], nbFrames))
+            {
+                PrintUsage(argv[0]);
+                return 1;
+            }
+        }
+        else if (strcmp(argv[i], "--stream") == 0)
+            streamLevels = true;
+        else if (strcmp(argv[i], "--xml-levels") == 0)
+            compiledLevels = false;
+        else if (strcmp(argv[i], "--write-compiled-levels") == 0)
+            writeCompiledLevels = true;
+        else if (strcmp(argv[i], "--hot-reload") == 0)
+            hotReload = true;
+        else if (strcmp(argv[i], "--allocation-tripwire") == 0)
+            AllocationTripwire::Enable();
+        else if (strcmp(argv[i], "--levels") == 0 && i + 1 < argc)
+            levels = Util::Split(argv[++i], ',');
+        else if (strcmp(argv[i], "--scenario") == 0 && i + 1 < argc)
+        {
+            if (!LevelGenerator::GenerateScenario(argv[++i]))
+                return 1;
+            levels.assign(1, argv[i]);
+        }
+        else if (strcmp(argv[i], "--generate-scenarios") == 0)
+            return LevelGenerator::GenerateScenarios() ? 0 : 1;
+        else if (strcmp(argv[i], "--compile-level") == 0 && i + 1 < argc)
+            return LevelCompiler::Compile(argv[i + 1]) ? 0 : 1;
+        else if (strcmp(argv[i], "--benchmark-level") == 0 && i + 1 < argc)
+        {
+            unsigned int nbRuns = 20;
+            if (i + 2 < argc && !ReadCount(argv[i + 2], nbRuns))
+            {
+                PrintUsage(argv[0]);
+                return 1;
+            }
+            LevelCompiler::BenchmarkLoading(argv[i + 1], nbRuns);
+            return 0;
+        }
+        else if (strcmp(argv[i], "--benchmark-xml") == 0 && i + 1 < argc)
+        {
+            unsigned int nbRuns = 5;
+            if (i + 2 < argc && !ReadCount(argv[i + 2], nbRuns))
+            {
+                PrintUsage(argv[0]);
+                return 1;
+            }
+            LevelCompiler::BenchmarkParsing(argv[i + 1], nbRuns);
+            return 0;
+        }
+        else if (strcmp(argv[i], "--capture") == 0 && i + 1 < argc)
+        {
+            captureDirectory = argv[++i];
+            if (i + 1 < argc && strcmp(argv[i + 1], "raw") == 0)
+            {
+                captureFormat = CAPTURE_RAW;
+                i++;
+            }
+            else if (i + 1 < argc && strcmp(argv[i + 1], "png") == 0)
+                i++;
+        }
+    }
+
+    // Nothing can close a headless game
+    if (rendererType != WINDOW_RENDERER && nbFrames == 0)
+        nbFrames = 600;
 
-    return 0;
+    Game* g = new Game(rendererType, nbFrames);
+    if (!captureDirectory.empty())
+        g->StartCapture(captureDirectory, captureFormat);
+    g->SetLevelStreaming(streamLevels);
+    g->SetCompiledLevels(compiledLevels);
+    g->SetWriteCompiledLevels(writeCompiledLevels);
+    if (!levels.empty())
+        g->SetLevels(levels);
+    g->SetHotReload(hotReload);
+	return g->Run() ? 0 : 1;
 }
@@ -0,0 +1,102 @@
+#include "AllocationTripwire.hpp"
+
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+	// Plain zero-initialized variables: operator new can be called before any constructor has run
+	bool s_enabled = false;
+	thread_local bool t_armed = false;
+	thread_local unsigned int t_nbAllocations = 0;
+	thread_local unsigned int t_nbExpectedScopes = 0; // ExpectedAllocations of the thread that exist: they can be nested
+}
+
+AllocationTripwire::ExpectedAllocations::ExpectedAllocations()
+{
+	t_nbExpectedScopes++;
+}
+
+AllocationTripwire::ExpectedAllocations::~ExpectedAllocations()
+{
+	t_nbExpectedScopes--;
+}
+
+void AllocationTripwire::Enable()
+{
+	s_enabled = true;
+}
+
+void AllocationTripwire::Arm()
+{
+	t_armed = s_enabled;
+	t_nbAllocations = 0;
+}
+
+void AllocationTripwire::StartFrame()
+{
+	t_nbAllocations = 0;
+}
+
+bool AllocationTripwire::EndFrame(unsigned int _frameNumber)
+{
+	if (!t_armed || t_nbAllocations == 0)
+		return true;
+
+	std::cerr << "Frame " << _frameNumber << ": " << t_nbAllocations << " heap allocations" << std::endl; // Printed after the count is read: this allocates too
+	return false;
+}
+
+unsigned int AllocationTripwire::GetNbAllocations()
+{
+	return t_nbAllocations;
+}
+
+// Replaces the global allocation functions of the whole program: the counter is the only difference with the default ones. Not armed, it costs a test
+void* operator new(std::size_t _size)
+{
+	if (t_armed && t_nbExpectedScopes == 0)
+		t_nbAllocations++;
+
+	void* memory = std::malloc(_size != 0 ? _size : 1);
+	if (memory == NULL)
+		throw std::bad_alloc();
+	return memory;
+}
+
+void* operator new[](std::size_t _size)
+{
+	return operator new(_size);
+}
+
+void* operator new(std::size_t _size, const std::nothrow_t&) noexcept
+{
+	if (t_armed && t_nbExpectedScopes == 0)
+		t_nbAllocations++;
+	return std::malloc(_size != 0 ? _size : 1);
+}
+
+void* operator new[](std::size_t _size, const std::nothrow_t& _nothrow) noexcept
+{
+	return operator new(_size, _nothrow);
+}
+
+void operator delete(void* _memory) noexcept
+{
+	std::free(_memory);
+}
+
+void operator delete[](void* _memory) noexcept
+{
+	std::free(_memory);
+}
+
+void operator delete(void* _memory, const std::nothrow_t&) noexcept
+{
+	std::free(_memory);
+}
+
+void operator delete[](void* _memory, const std::nothrow_t&) noexcept
+{
+	std::free(_memory);
+}
@@ -0,0 +1,34 @@
+#ifndef ALLOCATIONTRIPWIRE_H
+#define ALLOCATIONTRIPWIRE_H
+
+#include "Debug.hpp"
+
+/*
+*	Counts the calls to operator new made by the main thread during a frame, when it's enabled (--allocation-tripwire, meant for --headless runs without DEBUG_MODE)
+*	Once armed (the level is started and its containers have their size), a frame that allocates is a failure,
+*	unless the allocation is made where objects are created (an enemy spawns, Mario respawns...): in the scope of an ExpectedAllocations
+*/
+class AllocationTripwire
+{
+	public:
+		/* Excuses the allocations made by its thread while it exists, not the rest of the frame: declared around what creates objects, as narrowly as possible */
+		class ExpectedAllocations
+		{
+			public:
+				ExpectedAllocations();
+				~ExpectedAllocations();
+
+			private:
+				ExpectedAllocations(const ExpectedAllocations&);
+				ExpectedAllocations& operator=(const ExpectedAllocations&);
+		};
+
+		static void Enable(); // Before the game starts. Arm does nothing otherwise
+		static void Arm(); // Only the allocations of the calling thread are counted
+		static void StartFrame();
+		static bool EndFrame(unsigned int _frameNumber); // Reports and returns false if the frame allocated out of an ExpectedAllocations
+
+		static unsigned int GetNbAllocations();
+};
+
+#endif
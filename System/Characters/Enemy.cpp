@@ -17,10 +17,9 @@ void Enemy::Init()
 	m_class = ENEMY;
 }
 
-InfoForDisplay Enemy::GetInfoForDisplay()
+bool Enemy::IsSpriteReversed()
 {
-	m_reverseSprite = (m_facing == DRIGHT);
-	return MovingObject::GetInfoForDisplay();
+	return m_facing == DRIGHT;
 }
 
 void Enemy::UpdateAfterCollisionWithMapEdge(CollisionDirection _dir, float _gap)
@@ -13,12 +13,12 @@ class Enemy : public MovingObject
 		virtual float GetMaxAbsVelocity_X() = 0;
 		virtual void Move(Instruction _inst);
 
-		InfoForDisplay GetInfoForDisplay();
 		virtual void UpdateAfterCollision(CollisionDirection _dir, ObjectClass _classOfOtherObject) = 0;
 		void UpdateAfterCollisionWithMapEdge(CollisionDirection _dir, float _gap);
 
 	protected:
 
+		virtual bool IsSpriteReversed();
 		virtual void AddOwnAcceleration() = 0;
 };
 
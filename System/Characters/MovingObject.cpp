@@ -27,14 +27,13 @@ MovingObject::~MovingObject()
 
 }
 
-InfoForDisplay MovingObject::GetInfoForDisplay()
+State MovingObject::GetDisplayState() const
 {
-	InfoForDisplay info = DisplayableObject::GetInfoForDisplay();
 	if (m_jumpState == JUMPING || m_jumpState == REACHINGAPEX)
-		info.state = JUMP; // This state is for GraphicsEngine to know which sprite to display. GameEngine still needs to make a difference between "Jump and Walk" and "Jump and Run"
+		return JUMP; // This state is for GraphicsEngine to know which sprite to display. GameEngine still needs to make a difference between "Jump and Walk" and "Jump and Run"
 	if (m_jumpState == FALLING)
-		info.state = FALL;
-	return info;
+		return FALL;
+	return m_state;
 }
 
 void MovingObject::UpdateAfterCollisionWithMapEdge(CollisionDirection _dir, float _gap)
@@ -15,8 +15,6 @@ class MovingObject : public DisplayableObject
 
 		void Init();
 
-		virtual InfoForDisplay GetInfoForDisplay();
-
 		void UpdatePosition(float _dt);
 		virtual void UpdateAfterCollision(CollisionDirection _dir, ObjectClass _classOfOtherObject) = 0;
 		virtual void UpdateAfterCollisionWithMapEdge(CollisionDirection _dir, float _gap);
@@ -32,6 +30,7 @@ class MovingObject : public DisplayableObject
 
 		void MarkAsDead() { m_isDead = true; };
 		bool IsDead() { return m_isDead; };
+		Direction GetFacing() const { return m_facing; };
 
 #ifdef DEBUG_MODE
 		DebugInfo GetDebugInfo();
@@ -39,6 +38,9 @@ class MovingObject : public DisplayableObject
 
 
 	protected:
+		virtual State GetDisplayState() const;
+		virtual RenderLayer GetRenderLayer() const { return CHARACTER_LAYER; };
+
 		Direction m_facing;
 
 		JumpState m_jumpState;
@@ -25,10 +25,9 @@ Player:: ~Player()
 
 }
 
-InfoForDisplay Player::GetInfoForDisplay()
+bool Player::IsSpriteReversed()
 {
-	m_reverseSprite = (m_facing == DLEFT);
-	return MovingObject::GetInfoForDisplay();
+	return m_facing == DLEFT;
 }
 
 void Player::UpdateAfterCollision(CollisionDirection _dir, ObjectClass _classOfOtherObject)
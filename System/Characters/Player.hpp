@@ -12,7 +12,6 @@ class Player : public MovingObject
 
 		void Init();
 
-		InfoForDisplay GetInfoForDisplay();
 		virtual void UpdateAfterCollision(CollisionDirection _dir, ObjectClass _classOfOtherObject);
 
 		void ToggleRun(bool _mustRun);
@@ -24,6 +23,7 @@ class Player : public MovingObject
 
 	private:
 
+		virtual bool IsSpriteReversed();
 		virtual void AddOwnAcceleration();
 
 		bool m_canJump; // To avoid Mario jumping around if the jump key is pressed and held
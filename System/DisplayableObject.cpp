@@ -1,5 +1,7 @@
 #include "DisplayableObject.hpp"
 #include "EventEngine/EventEngine.hpp"
+#include "HitboxTable.hpp"
+#include "SpriteRegistry.hpp"
 
 unsigned int DisplayableObject::id = 1;
 
@@ -7,6 +9,7 @@ unsigned int DisplayableObject::id = 1;
 DisplayableObject::DisplayableObject()
 {
 	m_id = 0;
+	m_displayInfoSent = false;
 }
 
 DisplayableObject::DisplayableObject(EventEngine *_eventEngine, std::string _name, sf::Vector2f _coord, State _state) : DisplayableObject(_eventEngine, _name, _coord.x, _coord.y, _state)
@@ -22,6 +25,7 @@ DisplayableObject::DisplayableObject(EventEngine *_eventEngine, std::string _nam
 	DisplayableObject::id++;
 
 	m_name = _name;
+	m_spriteId = SpriteRegistry::GetId(_name);
 	m_coord.x = _x;
 	m_coord.y = _y;
 
@@ -29,6 +33,7 @@ DisplayableObject::DisplayableObject(EventEngine *_eventEngine, std::string _nam
 	m_state = _state;
 
 	m_reverseSprite = false;
+	m_displayInfoSent = false;
 }
 
 DisplayableObject::~DisplayableObject()
@@ -52,12 +57,40 @@ InfoForDisplay DisplayableObject::GetInfoForDisplay()
 	InfoForDisplay info;
 	info.id = m_id;
 	info.name = m_name;
-	info.state = m_state;
+	info.state = GetDisplayState();
 	info.coordinates = GetCoordinates();
-	info.reverse = m_reverseSprite;
+	info.reverse = IsSpriteReversed();
 	return info;
 }
 
+RenderCommand DisplayableObject::GetRenderCommand()
+{
+	RenderCommand command;
+	command.handle = m_id;
+	command.spriteId = m_spriteId;
+	command.state = GetDisplayState();
+	command.layer = GetRenderLayer();
+	command.flags = IsSpriteReversed() ? REVERSE_SPRITE : 0;
+	sf::Vector2f size = HitboxTable::GetSize(m_spriteId, GetDisplayState());
+	command.left = m_coord.x;
+	command.top = m_coord.y;
+	command.width = size.x;
+	command.height = size.y;
+	return command;
+}
+
+/* Change detection is done by g, so that nothing is sent to gfx for the objects that haven't changed since the last time */
+bool DisplayableObject::DisplayInfoChanged(const RenderCommand& _command)
+{
+	if (m_displayInfoSent && _command.state == m_sentCommand.state && _command.flags == m_sentCommand.flags
+		&& _command.left == m_sentCommand.left && _command.top == m_sentCommand.top && _command.width == m_sentCommand.width && _command.height == m_sentCommand.height)
+		return false;
+
+	m_displayInfoSent = true;
+	m_sentCommand = _command;
+	return true;
+}
+
 void DisplayableObject::UpdateAfterCollision(CollisionDirection _direction, ObjectClass _classOfOtherObject)
 {
 	/* Virtual. Nothing should happen here. Could be in moving object but some objects such as floor tiles might react to collisions one day */
@@ -65,7 +98,8 @@ void DisplayableObject::UpdateAfterCollision(CollisionDirection _direction, Obje
 
 sf::FloatRect DisplayableObject::GetCoordinates() const
 {
-	sf::FloatRect coords(m_coord.x, m_coord.y, m_size.x, m_size.y);
+	sf::Vector2f size = HitboxTable::GetSize(m_spriteId, GetDisplayState());
+	sf::FloatRect coords(m_coord.x, m_coord.y, size.x, size.y);
 	return coords;
 }
 
@@ -73,6 +107,4 @@ void DisplayableObject::SetCoordinates(const sf::FloatRect _coord)
 {
 	m_coord.x = _coord.left;
 	m_coord.y = _coord.top;
-	m_size.x = _coord.width;
-	m_size.y = _coord.height;
 }
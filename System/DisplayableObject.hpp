@@ -4,18 +4,18 @@
 #include <SFML/System/Vector2.hpp>
 #include "Debug.hpp"
 #include "PhysicsConstants.hpp"
+#include "RenderCommandBuffer.hpp"
 
 class EventEngine;
 
 /*
-*	Information sent from g to gfx for display. The name and state will be used to fetch the correct sprite.
+*	Information about an object sent by g with events (e.g. when a character dies). What gfx needs every frame is sent as a RenderCommand instead.
 */
 struct InfoForDisplay
 {
 	unsigned int id;
-	std::string name;	// to find sprite
-	std::string currentSprite;
-	State state;		// Idem
+	std::string name;
+	State state;
 	sf::FloatRect coordinates;
 	bool reverse;		// Reverse sprite display (left/right) ?
 };
@@ -31,17 +31,21 @@ class DisplayableObject
 		DisplayableObject(EventEngine *_eventEngine, std::string _name, float _x, float _y, State _state = UNKNOWN);
 		virtual ~DisplayableObject();
 
-		virtual InfoForDisplay GetInfoForDisplay();
+		InfoForDisplay GetInfoForDisplay();
+		RenderCommand GetRenderCommand();
+		bool DisplayInfoChanged(const RenderCommand& _command);
 		virtual void UpdateAfterCollision(CollisionDirection _direction, ObjectClass _classOfOtherObject);
 
 		sf::FloatRect GetCoordinates() const;
-		void SetCoordinates(const sf::FloatRect _coord);
+		void SetCoordinates(const sf::FloatRect _coord); // Only the position: the size comes from the hitbox table
 		sf::Vector2f GetPosition() const { return m_coord; };
 		void SetPosition(const sf::Vector2f _pos) { m_coord = _pos; };
 		ObjectClass GetClass() const { return m_class; };
 		State GetState() const { return m_state; };
+		void SetState(State _state) { m_state = _state; };
 		unsigned int GetID() const { return m_id; };
 		std::string GetName() const { return m_name; };
+		unsigned int GetSpriteId() const { return m_spriteId; };
 		void SetX(const float _x) { m_coord.x = _x; };
 		void SetY(const float _y) { m_coord.y = _y; };
 
@@ -49,18 +53,26 @@ class DisplayableObject
 		void Slide(float _x, float _y);
 
 	protected:
+		virtual State GetDisplayState() const { return m_state; }; // The state gfx picks the sprite from, and the hitbox
+		virtual bool IsSpriteReversed() { return m_reverseSprite; };
+		virtual RenderLayer GetRenderLayer() const { return FOREGROUND_LAYER; };
+
 		EventEngine *m_eventEngine; // Any displayable object can trigger an event
 
 		int m_id; // Unique identifier for each object
 		std::string m_name;
+		unsigned int m_spriteId; // Id of m_name in SpriteRegistry
 		ObjectClass m_class;
 		State m_state;
 
 		sf::Vector2f m_coord; // Origin: the top left corner, with respect to the top left corner of the window
-		sf::Vector2f m_size;
 
 		bool m_reverseSprite;
 
+		// What was sent to gfx last: nothing is sent again if it didn't change
+		bool m_displayInfoSent;
+		RenderCommand m_sentCommand;
+
 	private:
 		static unsigned int id;
 };
@@ -5,6 +5,8 @@
 
 class MovingObject;
 class Pipe;
+class RenderCommandBuffer;
+class TileMap;
 
 #ifdef DEBUG_MODE
 struct DebugInfo;
@@ -27,6 +29,8 @@ class Event
 		Event(DisplayableObject *_displayableObject) { m_displayableObject = _displayableObject; };
 		Event(Pipe *_pipe) { m_pipe = _pipe; };
 		Event(InfoForDisplay *_infoForDisplay) { m_infoForDisplay = _infoForDisplay; };
+		Event(RenderCommandBuffer *_renderCommands) { m_renderCommands = _renderCommands; };
+		Event(TileMap *_tileMap) { m_tileMap = _tileMap; };
 #ifdef DEBUG_MODE
 		Event(DebugInfo *_debugInfo) { m_debugInfo = _debugInfo; };
 #endif
@@ -40,6 +44,8 @@ class Event
 		DisplayableObject* GetDisplayableObject() { return m_displayableObject; };
 		Pipe* GetPipe() { return m_pipe; };
 		InfoForDisplay* GetInfoForDisplay() { return m_infoForDisplay; };
+		RenderCommandBuffer* GetRenderCommands() { return m_renderCommands; };
+		TileMap* GetTileMap() { return m_tileMap; };
 #ifdef DEBUG_MODE
 		DebugInfo* GetDebugInfo() { return m_debugInfo; };
 #endif
@@ -56,6 +62,8 @@ class Event
 		DisplayableObject *m_displayableObject;
 		Pipe *m_pipe;
 		InfoForDisplay *m_infoForDisplay;
+		RenderCommandBuffer *m_renderCommands;
+		TileMap *m_tileMap;
 #ifdef DEBUG_MODE
 		DebugInfo *m_debugInfo;
 #endif
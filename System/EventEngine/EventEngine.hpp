@@ -3,6 +3,8 @@
 
 #include "KeyboardEvent.hpp"
 #include "EventListener.hpp"
+#include <cstring>
+#include <deque>
 #include <map>
 #include <iostream>
 #include <queue>
@@ -37,8 +39,23 @@ class EventEngine
          */
         void dispatch(const std::string &_eventType, Event* _event);
 
+        /**
+         * Send a new Event named by a C string (the defines of GameEvents.hpp...)
+         * Each name is only turned into a string the first time it's seen, so that dispatching in a frame doesn't allocate
+         * @param char* _eventType Name of the event, only read during the call
+         * @param Event* _event The event object
+         */
+        void dispatch(const char* _eventType, Event* _event);
+
     private:
+        struct NameLess
+        {
+            bool operator()(const char* _a, const char* _b) const { return strcmp(_a, _b) < 0; }
+        };
+
         std::map<std::string, std::vector<EventListener*>> m_specificListeners;
+        std::deque<std::string> m_names; // Every name dispatched as a C string. Adding one doesn't move the others
+        std::map<const char*, const std::string*, NameLess> m_nameIndex; // By content: the keys are the names of m_names
         std::vector<EventListener*> m_generalsListeners;
 };
 
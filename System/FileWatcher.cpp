@@ -0,0 +1,170 @@
+#include <iostream>
+#include <sys/stat.h>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX // std::max
+#include <windows.h>
+#endif
+#include "FileWatcher.hpp"
+#include "AllocationTripwire.hpp"
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+FileWatcher::FileWatcher() : m_inotify(-1)
+#else
+FileWatcher::FileWatcher()
+#endif
+{
+}
+
+FileWatcher::~FileWatcher()
+{
+	Clear();
+}
+
+bool FileWatcher::Watch(const std::string& _fileName)
+{
+	for (unsigned int i = 0; i < m_files.size(); i++)
+	{
+		if (m_files[i].fileName == _fileName)
+			return true;
+	}
+
+	WatchedFile file;
+	file.fileName = _fileName;
+	std::string::size_type slash = _fileName.find_last_of("/\\");
+	file.name = slash == std::string::npos ? _fileName : _fileName.substr(slash + 1);
+	file.directory = -1;
+	file.time = GetModificationTime(_fileName);
+	file.changed = false;
+
+#ifdef __linux__
+	if (m_inotify == -1)
+	{
+		m_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (m_inotify == -1)
+		{
+			std::cerr << "Can't watch the level files: " << strerror(errno) << std::endl;
+			return false;
+		}
+	}
+
+	// The same directory gives the same watch
+	std::string directory = slash == std::string::npos ? "." : _fileName.substr(0, slash);
+	file.directory = inotify_add_watch(m_inotify, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+	if (file.directory == -1)
+	{
+		std::cerr << "Can't watch " << directory << ": " << strerror(errno) << std::endl;
+		return false;
+	}
+#endif
+
+	m_files.push_back(file);
+	return true;
+}
+
+void FileWatcher::Clear()
+{
+	m_files.clear();
+#ifdef __linux__
+	if (m_inotify != -1)
+		close(m_inotify); // Its watches go with it
+	m_inotify = -1;
+#endif
+}
+
+bool FileWatcher::PopChangedFile(std::string& _fileName)
+{
+#ifdef __linux__
+	ReadEvents();
+#else
+	PollFiles();
+#endif
+
+	for (unsigned int i = 0; i < m_files.size(); i++)
+	{
+		if (m_files[i].changed)
+		{
+			m_files[i].changed = false;
+			AllocationTripwire::ExpectedAllocations expectedAllocations; // A file changed: the frame reloads it anyway
+			_fileName = m_files[i].fileName;
+			return true;
+		}
+	}
+	return false;
+}
+
+#ifdef __linux__
+void FileWatcher::ReadEvents()
+{
+	if (m_inotify == -1)
+		return;
+
+	alignas(inotify_event) char events[4096];
+	ssize_t size;
+	while ((size = read(m_inotify, events, sizeof(events))) > 0)
+	{
+		for (char *next = events; next < events + size; next += sizeof(inotify_event) + ((inotify_event*)next)->len)
+		{
+			const inotify_event *event = (const inotify_event*)next;
+			for (unsigned int i = 0; i < m_files.size(); i++)
+			{
+				if (event->len > 0 && m_files[i].directory == event->wd && m_files[i].name == event->name)
+					m_files[i].changed = true;
+			}
+		}
+	}
+}
+#else
+void FileWatcher::PollFiles()
+{
+	if (m_pollClock.getElapsedTime().asMilliseconds() < 500)
+		return;
+	m_pollClock.restart();
+
+	for (unsigned int i = 0; i < m_files.size(); i++)
+	{
+		long long time = GetModificationTime(m_files[i].fileName);
+		if (time != m_files[i].time && time != -1)
+		{
+			m_files[i].time = time;
+			m_files[i].changed = true;
+		}
+	}
+}
+#endif
+
+bool FileWatcher::GetFileInfo(const std::string& _fileName, long long& _time, unsigned int& _size)
+{
+#ifdef _WIN32
+	WIN32_FILE_ATTRIBUTE_DATA info;
+	if (!GetFileAttributesExA(_fileName.c_str(), GetFileExInfoStandard, &info))
+		return false;
+	_time = ((long long)info.ftLastWriteTime.dwHighDateTime << 32) | info.ftLastWriteTime.dwLowDateTime; // In 100 ns
+	_size = (unsigned int)info.nFileSizeLow;
+#else
+	struct stat info;
+	if (stat(_fileName.c_str(), &info) != 0)
+		return false;
+#ifdef __APPLE__
+	_time = (long long)info.st_mtimespec.tv_sec * 1000000000 + info.st_mtimespec.tv_nsec;
+#else
+	_time = (long long)info.st_mtim.tv_sec * 1000000000 + info.st_mtim.tv_nsec;
+#endif
+	_size = (unsigned int)info.st_size;
+#endif
+	return true;
+}
+
+long long FileWatcher::GetModificationTime(const std::string& _fileName)
+{
+	long long time;
+	unsigned int size;
+	return GetFileInfo(_fileName, time, size) ? time : -1;
+}
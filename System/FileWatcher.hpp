@@ -0,0 +1,53 @@
+#ifndef FILEWATCHER_H
+#define FILEWATCHER_H
+
+#include <string>
+#include <vector>
+#include <SFML/System/Clock.hpp>
+
+/*
+*	Tells which of the watched files were written since the last time it was asked, to be asked every frame: nothing is allocated when nothing changed
+*	On Linux, inotify watches the directories of the files (editors often write a new file and rename it over the old one): a read that returns at once
+*	Elsewhere, the modification times of the files are compared every half second
+*/
+class FileWatcher
+{
+	public:
+		FileWatcher();
+		~FileWatcher();
+
+		bool Watch(const std::string& _fileName);
+		void Clear(); // No file is watched anymore
+
+		bool PopChangedFile(std::string& _fileName); // False if no watched file changed
+
+		/* Modification time as precisely as the system gives it (ns, 100 ns on Windows): a file saved twice in the same second isn't the same file */
+		static bool GetFileInfo(const std::string& _fileName, long long& _time, unsigned int& _size);
+
+	private:
+		FileWatcher(const FileWatcher&);
+		FileWatcher& operator=(const FileWatcher&);
+
+		struct WatchedFile
+		{
+			std::string fileName;	// As given to Watch
+			std::string name;		// Without the directory
+			int directory;			// inotify watch of the directory
+			long long time;			// Last modification time seen
+			bool changed;
+		};
+
+		std::vector<WatchedFile> m_files;
+
+#ifdef __linux__
+		int m_inotify;
+		void ReadEvents();
+#else
+		sf::Clock m_pollClock;
+		void PollFiles();
+#endif
+
+		static long long GetModificationTime(const std::string& _fileName); // -1 if the file isn't there
+};
+
+#endif
@@ -0,0 +1,69 @@
+#include "FrameArena.hpp"
+
+#include <cstdint>
+#include <new>
+
+FrameArena::FrameArena(std::size_t _capacity) : m_capacity(_capacity), m_used(0), m_highWaterMark(0), m_nbOverflows(0), m_overflowBlocks(NULL)
+{
+	m_block = new char[m_capacity];
+}
+
+FrameArena::~FrameArena()
+{
+	Reset();
+	delete[] m_block;
+}
+
+FrameArena& FrameArena::Get()
+{
+	// Function static rather than static member: static variables don't get initialized in the other projects (see Util::GetAssetsPath)
+	static FrameArena arena(64 * 1024);
+	return arena;
+}
+
+void* FrameArena::Allocate(std::size_t _size, std::size_t _alignment)
+{
+	if (m_used <= m_capacity)
+	{
+		std::uintptr_t start = reinterpret_cast<std::uintptr_t>(m_block) + m_used;
+		std::size_t padding = (_alignment - start % _alignment) % _alignment;
+		if (m_used + padding + _size <= m_capacity)
+		{
+			m_used += padding + _size;
+			return m_block + m_used - _size;
+		}
+	}
+
+	// Overflow: the memory is still counted, so that the high-water mark says how big the frame really was
+	m_used += _size + _alignment;
+	std::size_t headerSize = (sizeof(OverflowBlock) + _alignment - 1) / _alignment * _alignment;
+	char *memory = static_cast<char*>(::operator new(headerSize + _size));
+	OverflowBlock *block = reinterpret_cast<OverflowBlock*>(memory);
+	block->next = m_overflowBlocks;
+	m_overflowBlocks = block;
+	return memory + headerSize;
+}
+
+void FrameArena::Reset()
+{
+	if (m_used > m_highWaterMark)
+		m_highWaterMark = m_used;
+
+	if (m_overflowBlocks != NULL)
+	{
+		while (m_overflowBlocks != NULL)
+		{
+			OverflowBlock *next = m_overflowBlocks->next;
+			::operator delete(m_overflowBlocks);
+			m_overflowBlocks = next;
+		}
+
+		// Only the frames that overflowed pay for the growth
+		m_nbOverflows++;
+		delete[] m_block;
+		m_capacity = m_highWaterMark;
+		m_block = new char[m_capacity];
+	}
+
+	m_used = 0;
+}
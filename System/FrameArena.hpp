@@ -0,0 +1,77 @@
+#ifndef FRAMEARENA_H
+#define FRAMEARENA_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/*
+*	Bump allocator for what only lives during one frame (collision candidates, debug text...): allocating is moving a pointer,
+*	and everything is freed at once by Reset, at the end of the frame (see Game::Run). Main thread only
+*	If a frame needs more than the capacity, the extra memory comes from the heap and the block is grown to the high-water mark at the next Reset
+*/
+class FrameArena
+{
+	public:
+		FrameArena(std::size_t _capacity);
+		~FrameArena();
+
+		static FrameArena& Get(); // The arena shared by the engines
+
+		void* Allocate(std::size_t _size, std::size_t _alignment);
+		void Reset();
+
+		std::size_t GetCapacity() const { return m_capacity; };
+		std::size_t GetHighWaterMark() const { return m_highWaterMark; }; // Biggest frame seen, in bytes
+		unsigned int GetNbOverflows() const { return m_nbOverflows; }; // Frames that needed more than the capacity
+
+	private:
+		struct OverflowBlock
+		{
+			OverflowBlock *next;
+		};
+
+		char *m_block;
+		std::size_t m_capacity;
+		std::size_t m_used; // Used in the frame, overflow included
+		std::size_t m_highWaterMark;
+		unsigned int m_nbOverflows;
+		OverflowBlock *m_overflowBlocks; // Freed by Reset
+
+		FrameArena(const FrameArena&);
+		FrameArena& operator=(const FrameArena&);
+};
+
+/*
+*	STL allocator on the frame arena: std::vector<T, FrameAllocator<T> > for a list built and dropped in the same frame
+*	Deallocating does nothing, the memory comes back with FrameArena::Reset
+*/
+template <typename T>
+class FrameAllocator
+{
+	public:
+		typedef T value_type;
+
+		FrameAllocator() : m_arena(&FrameArena::Get()) { };
+		FrameAllocator(FrameArena& _arena) : m_arena(&_arena) { };
+		template <typename U> FrameAllocator(const FrameAllocator<U>& _other) : m_arena(_other.GetArena()) { };
+
+		T* allocate(std::size_t _nb) { return static_cast<T*>(m_arena->Allocate(_nb * sizeof(T), alignof(T))); };
+		void deallocate(T*, std::size_t) { };
+
+		FrameArena* GetArena() const { return m_arena; };
+
+	private:
+		FrameArena *m_arena;
+};
+
+template <typename T, typename U>
+bool operator==(const FrameAllocator<T>& _a, const FrameAllocator<U>& _b) { return _a.GetArena() == _b.GetArena(); }
+template <typename T, typename U>
+bool operator!=(const FrameAllocator<T>& _a, const FrameAllocator<U>& _b) { return _a.GetArena() != _b.GetArena(); }
+
+template <typename T>
+using FrameVector = std::vector<T, FrameAllocator<T> >;
+typedef std::basic_string<char, std::char_traits<char>, FrameAllocator<char> > FrameString;
+
+#endif
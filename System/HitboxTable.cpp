@@ -0,0 +1,72 @@
+#include "HitboxTable.hpp"
+#include "SpriteRegistry.hpp"
+#include "AllocationTripwire.hpp"
+
+void HitboxTable::Load()
+{
+	const std::vector<std::string>& sheets = Util::GetSpriteSheetNames();
+	for (unsigned int i = 0; i < sheets.size(); i++)
+	{
+		std::vector<SpriteRect> rects = Util::ReadRectFile(sheets[i]);
+		for (unsigned int j = 0; j < rects.size(); j++)
+			SizesByName()[rects[j].name] = sf::Vector2f((float)rects[j].rect.width, (float)rects[j].rect.height);
+	}
+}
+
+sf::Vector2f HitboxTable::GetSize(unsigned int _spriteId, State _state)
+{
+	if (_spriteId >= SizesBySprite().size() || SizesBySprite()[_spriteId].empty())
+		ResolveSprite(_spriteId);
+	return SizesBySprite()[_spriteId][_state];
+}
+
+/* A state without sprite gets the size of the first state that has one, so an object never has an empty hitbox */
+void HitboxTable::ResolveSprite(unsigned int _spriteId)
+{
+	AllocationTripwire::ExpectedAllocations expectedAllocations; // Once per sprite, the first time an object uses it
+	if (_spriteId >= SizesBySprite().size())
+		SizesBySprite().resize(_spriteId + 1);
+
+	std::vector<sf::Vector2f>& sizes = SizesBySprite()[_spriteId];
+	sizes.resize(Sprite::NbStates);
+
+	const std::string& name = SpriteRegistry::GetName(_spriteId);
+	std::vector<bool> found(Sprite::NbStates, false);
+	sf::Vector2f defaultSize;
+	bool hasDefault = false;
+	for (int state = 0; state < Sprite::NbStates; state++)
+	{
+		std::string fullName = Util::GetFullStateName(name, (State)state);
+		std::map<std::string, sf::Vector2f>::iterator it = SizesByName().find(fullName);
+		if (it == SizesByName().end())
+			it = SizesByName().find(fullName + "1"); // Animation
+		if (it == SizesByName().end())
+			continue;
+
+		sizes[state] = it->second;
+		found[state] = true;
+		if (!hasDefault)
+		{
+			defaultSize = it->second;
+			hasDefault = true;
+		}
+	}
+
+	for (int state = 0; state < Sprite::NbStates; state++)
+	{
+		if (!found[state])
+			sizes[state] = defaultSize;
+	}
+}
+
+std::map<std::string, sf::Vector2f>& HitboxTable::SizesByName()
+{
+	static std::map<std::string, sf::Vector2f> sizes;
+	return sizes;
+}
+
+std::vector<std::vector<sf::Vector2f> >& HitboxTable::SizesBySprite()
+{
+	static std::vector<std::vector<sf::Vector2f> > sizes;
+	return sizes;
+}
@@ -0,0 +1,27 @@
+#ifndef HITBOXTABLE_H
+#define HITBOXTABLE_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include "Util.hpp"
+
+/*
+*	Size of each sprite (see SpriteRegistry) in each state, read from the RECT files: g knows the size of the objects without waiting for gfx to draw them
+*	The size of an animated state is the size of its first frame
+*/
+class HitboxTable
+{
+	public:
+		static void Load(); // Reads the RECT files, done once by GameEngine
+		static sf::Vector2f GetSize(unsigned int _spriteId, State _state);
+
+	private:
+		// Function statics rather than static members: static variables don't get initialized in the other projects (see Util::GetAssetsPath)
+		static std::map<std::string, sf::Vector2f>& SizesByName();
+		static std::vector<std::vector<sf::Vector2f> >& SizesBySprite(); // Sprite id -> size per state, filled the first time the sprite is met
+
+		static void ResolveSprite(unsigned int _spriteId);
+};
+
+#endif
@@ -1,35 +1,35 @@
 #include "Pipe.hpp"
+#include "../AllocationTripwire.hpp"
 
 const int Pipe::milisecondsBetweenSpawns = 3000;
 
-Pipe::Pipe(std::string _name, sf::Vector2f _coord, int _pipeId, PipeType _type, EventEngine *_eventEngine) : DisplayableObject(_eventEngine, _name, _coord, NORMAL), m_pipeId(_pipeId), m_type(_type)
+Pipe::Pipe(std::string _name, sf::Vector2f _coord, int _pipeId, PipeType _type, EventEngine *_eventEngine) : DisplayableObject(_eventEngine, _name, _coord, NORMAL), m_pipeId(_pipeId), m_type(_type),
+	m_spawnTimer(this), m_timers(NULL)
 {
 	m_spawnIsOn = true;
 	m_enemyBeingSpawned = NULL;
-	m_enemyInfo = new InfoForDisplay();
 	m_justFinishedSpawn = false;
-	m_spawnTimer.restart();
+	m_spawnIsDue = false;
 }
 
 Pipe::~Pipe()
 {
 	delete m_enemyBeingSpawned;
-	delete m_enemyInfo;
 }
 
-void Pipe::HandleSpawnEnemies(float _dt)
+void Pipe::HandleSpawnEnemies(float _dt, RenderCommandBuffer& _renderCommands)
 {
 	if (m_spawnIsOn)
-		SpawnEnemyIfTimeElapsed();
+		SpawnEnemyIfDue();
 
 	if (m_enemyBeingSpawned != NULL)
 	{
 		MoveEnemyBeingSpawned(_dt);
-		SendEnemyBeingSpawnedToGFX();
+		SendEnemyBeingSpawnedToGFX(_renderCommands);
 
 		if (m_justFinishedSpawn)
 		{
-			RemoveEnemyBeingSpawned();
+			RemoveEnemyBeingSpawned(_renderCommands);
 			m_justFinishedSpawn = false;
 		}
 
@@ -43,13 +43,17 @@ void Pipe::HandleSpawnEnemies(float _dt)
 	}
 }
 
-void Pipe::SpawnEnemyIfTimeElapsed()
+void Pipe::SpawnEnemyIfDue()
 {
-	if (m_enemyBeingSpawned == NULL && m_spawnTimer.getElapsedTime().asMilliseconds() > Pipe::milisecondsBetweenSpawns)
+	if (m_enemyBeingSpawned == NULL && m_spawnIsDue)
 	{
-		m_enemyBeingSpawned = new DisplayableObject(m_eventEngine, "goomba_fall", m_coord.x + 8, m_coord.y + 8); // Name is for gfx to pick the right sprite name: needs to be the full name as it is in the .rect file
+		{
+			AllocationTripwire::ExpectedAllocations expectedAllocations;
+			m_enemyBeingSpawned = new DisplayableObject(m_eventEngine, "goomba_fall", m_coord.x + 8, m_coord.y + 8); // Name is for gfx to pick the right sprite name: needs to be the full name as it is in the .rect file
+		}
 
-		m_spawnTimer.restart();
+		m_spawnIsDue = false;
+		m_timers->Schedule(m_spawnTimer, Pipe::milisecondsBetweenSpawns);
 	}
 }
 
@@ -58,18 +62,23 @@ void Pipe::MoveEnemyBeingSpawned(float _dt)
 	m_enemyBeingSpawned->Slide(-PhysicsConstants::EnemySpeedInPipe * _dt, 0);
 }
 
-void Pipe::SendEnemyBeingSpawnedToGFX()
+void Pipe::SendEnemyBeingSpawnedToGFX(RenderCommandBuffer& _renderCommands)
 {
-	*m_enemyInfo = m_enemyBeingSpawned->GetInfoForDisplay();
-	Event tmpEvent(m_enemyInfo);
-	m_eventEngine->dispatch("game.foreground_item_updated", &tmpEvent);
+	RenderCommand command = m_enemyBeingSpawned->GetRenderCommand();
+	command.layer = FOREGROUND_LAYER; // Drawn behind the pipe while it comes out of it
+	if (m_enemyBeingSpawned->DisplayInfoChanged(command))
+		_renderCommands.Push(command);
 }
 
 void Pipe::PublishEnemyCreation()
 {
 	if (m_enemyBeingSpawned != NULL)
 	{
-		Goomba *goombaJustSpawned = new Goomba(m_eventEngine, "goomba", m_enemyBeingSpawned->GetPosition(), DLEFT); // Will be deleted by game engine when character dies
+		Goomba *goombaJustSpawned = NULL;
+		{
+			AllocationTripwire::ExpectedAllocations expectedAllocations;
+			goombaJustSpawned = new Goomba(m_eventEngine, "goomba", m_enemyBeingSpawned->GetPosition(), DLEFT); // Will be deleted by game engine when character dies
+		}
 		Event newGoomba(goombaJustSpawned);
 		m_eventEngine->dispatch("game.new_character_read", &newGoomba);
 
@@ -77,11 +86,37 @@ void Pipe::PublishEnemyCreation()
 	}
 }
 
-void Pipe::RemoveEnemyBeingSpawned()
+void Pipe::StartSpawning(TimerWheel& _timers)
+{
+	m_timers = &_timers;
+	m_spawnIsDue = false;
+	m_timers->Schedule(m_spawnTimer, Pipe::milisecondsBetweenSpawns);
+}
+
+void Pipe::CancelSpawn(RenderCommandBuffer& _renderCommands)
+{
+	if (m_enemyBeingSpawned != NULL)
+		RemoveEnemyBeingSpawned(_renderCommands);
+	m_justFinishedSpawn = false;
+	m_spawnTimer.Cancel();
+	m_spawnIsDue = false;
+}
+
+void Pipe::Reset(RenderCommandBuffer& _renderCommands)
+{
+	CancelSpawn(_renderCommands);
+	m_spawnIsOn = true;
+	if (m_timers != NULL)
+		StartSpawning(*m_timers);
+}
+
+void Pipe::RemoveEnemyBeingSpawned(RenderCommandBuffer& _renderCommands)
 {
 	/* The enemy used to be a simple displayableObject (as seen by GFX), we remove it... */
-	Event removeEnemyBeingSpawned(m_enemyBeingSpawned->GetID());
-	m_eventEngine->dispatch("game.foreground_item_removed", &removeEnemyBeingSpawned);
+	RenderCommand removeEnemyBeingSpawned = m_enemyBeingSpawned->GetRenderCommand();
+	removeEnemyBeingSpawned.layer = FOREGROUND_LAYER;
+	removeEnemyBeingSpawned.flags |= REMOVE_SPRITE;
+	_renderCommands.Push(removeEnemyBeingSpawned);
 
 	delete m_enemyBeingSpawned;
 	m_enemyBeingSpawned = NULL;
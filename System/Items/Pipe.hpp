@@ -4,13 +4,14 @@
 #include "../DisplayableObject.hpp"
 #include "../EventEngine/EventEngine.hpp"
 #include "../Characters/Goomba.hpp"
-#include <SFML/System/Clock.hpp>
+#include "../TimerWheel.hpp"
 
 class GameEngine;
 class Enemy;
 
 /*
 *	A Pipe can be used to travel, to spawn enemies
+*	A spawning pipe counts the time between two enemies on the timers of the game (see TimerWheel), from StartSpawning on
 */
 class Pipe : public DisplayableObject
 {
@@ -18,29 +19,45 @@ class Pipe : public DisplayableObject
 		Pipe(std::string _name, sf::Vector2f _coord, int _pipeId, PipeType _type, EventEngine *_eventEngine);
 		~Pipe();
 
-		void HandleSpawnEnemies(float _dt);
+		void HandleSpawnEnemies(float _dt, RenderCommandBuffer& _renderCommands);
 
 		unsigned int GetPipeId() { return m_pipeId; };
 		PipeType GetPipeType() { return m_type; };
 
 		void ToggleSpawn() { m_spawnIsOn = !m_spawnIsOn; };
+		void StartSpawning(TimerWheel& _timers); // When it's in the level: the time between spawns starts
+		void CancelSpawn(RenderCommandBuffer& _renderCommands); // The enemy in the pipe is removed, if there is one, and the time between spawns stops
+		void Reset(RenderCommandBuffer& _renderCommands); // As it was started: spawning, the time between spawns starting again
 
 	protected:
+		virtual RenderLayer GetRenderLayer() const { return PIPE_LAYER; };
+
 		unsigned int m_pipeId;
 		PipeType m_type;
 
 		bool m_spawnIsOn;
 		DisplayableObject *m_enemyBeingSpawned; // One enemy at a time can be spawed and controlled by the pipe
-		InfoForDisplay *m_enemyInfo;
 		bool m_justFinishedSpawn;
-		sf::Clock m_spawnTimer;
+
+		class SpawnTimer : public Timer
+		{
+			public:
+				SpawnTimer(Pipe *_pipe) : m_pipe(_pipe) {};
+			protected:
+				virtual void OnExpired() { m_pipe->m_spawnIsDue = true; };
+			private:
+				Pipe *m_pipe;
+		};
+		SpawnTimer m_spawnTimer;
+		TimerWheel *m_timers; // NULL until StartSpawning
+		bool m_spawnIsDue; // The time between spawns elapsed: the next enemy comes as soon as the spawn is on and the pipe is free
 
 		void MoveEnemyBeingSpawned(float _dt);
-		void SpawnEnemyIfTimeElapsed();
-		void SendEnemyBeingSpawnedToGFX();
+		void SpawnEnemyIfDue();
+		void SendEnemyBeingSpawnedToGFX(RenderCommandBuffer& _renderCommands);
 
 		void PublishEnemyCreation();
-		void RemoveEnemyBeingSpawned();
+		void RemoveEnemyBeingSpawned(RenderCommandBuffer& _renderCommands);
 
 		bool IsEnemyReadyToLeavePipe();
 
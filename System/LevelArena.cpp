@@ -0,0 +1,58 @@
+#include "LevelArena.hpp"
+
+#include <cstdint>
+
+LevelArena::LevelArena(std::size_t _chunkSize) : m_chunkSize(_chunkSize), m_chunks(NULL), m_destructors(NULL), m_nbBytes(0), m_nbObjects(0)
+{
+
+}
+
+LevelArena::~LevelArena()
+{
+	Release();
+}
+
+void LevelArena::Release()
+{
+	while (m_destructors != NULL)
+	{
+		Destructor *next = m_destructors->next; // The record itself is in a chunk: read before the object goes
+		m_destructors->destroy(m_destructors->object);
+		m_destructors = next;
+	}
+
+	while (m_chunks != NULL)
+	{
+		Chunk *next = m_chunks->next;
+		::operator delete(m_chunks);
+		m_chunks = next;
+	}
+
+	m_nbBytes = 0;
+	m_nbObjects = 0;
+}
+
+void* LevelArena::Allocate(std::size_t _size, std::size_t _alignment)
+{
+	if (m_chunks != NULL)
+	{
+		std::uintptr_t start = reinterpret_cast<std::uintptr_t>(m_chunks + 1) + m_chunks->used;
+		std::size_t padding = (_alignment - start % _alignment) % _alignment;
+		if (m_chunks->used + padding + _size <= m_chunks->size)
+		{
+			m_chunks->used += padding + _size;
+			return reinterpret_cast<char*>(start + padding);
+		}
+	}
+
+	// New chunk: an object bigger than a chunk gets one of its own size
+	std::size_t size = _size + _alignment > m_chunkSize ? _size + _alignment : m_chunkSize;
+	Chunk *chunk = static_cast<Chunk*>(::operator new(sizeof(Chunk) + size));
+	chunk->next = m_chunks;
+	chunk->size = size;
+	chunk->used = 0;
+	m_chunks = chunk;
+	m_nbBytes += sizeof(Chunk) + size;
+
+	return Allocate(_size, _alignment);
+}
@@ -0,0 +1,68 @@
+#ifndef LEVELARENA_H
+#define LEVELARENA_H
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+/*
+*	Memory of the objects that live as long as the level (boxes, pipes...): they are placed one after the other in big chunks,
+*	and Release destroys them all and frees the chunks in one go when the level is unloaded. Objects created here must never be deleted
+*/
+class LevelArena
+{
+	public:
+		LevelArena(std::size_t _chunkSize = 64 * 1024);
+		~LevelArena();
+
+		template <typename T, typename... Args>
+		T* Create(Args&&... _args)
+		{
+			void *memory = Allocate(sizeof(T), alignof(T));
+			T *object = new (memory) T(std::forward<Args>(_args)...);
+
+			Destructor *destructor = new (Allocate(sizeof(Destructor), alignof(Destructor))) Destructor;
+			destructor->destroy = &LevelArena::Destroy<T>;
+			destructor->object = object;
+			destructor->next = m_destructors;
+			m_destructors = destructor;
+			m_nbObjects++;
+			return object;
+		};
+
+		void Release(); // The objects are destroyed in the reverse order of their creation
+
+		std::size_t GetNbBytes() const { return m_nbBytes; }; // Allocated from the system, headers included
+		unsigned int GetNbObjects() const { return m_nbObjects; };
+
+	private:
+		struct Chunk
+		{
+			Chunk *next;
+			std::size_t size;
+			std::size_t used;
+		};
+
+		struct Destructor
+		{
+			void (*destroy)(void*);
+			void *object;
+			Destructor *next;
+		};
+
+		std::size_t m_chunkSize;
+		Chunk *m_chunks; // The current chunk first
+		Destructor *m_destructors; // The last created object first
+		std::size_t m_nbBytes;
+		unsigned int m_nbObjects;
+
+		void* Allocate(std::size_t _size, std::size_t _alignment);
+
+		template <typename T>
+		static void Destroy(void *_object) { static_cast<T*>(_object)->~T(); };
+
+		LevelArena(const LevelArena&);
+		LevelArena& operator=(const LevelArena&);
+};
+
+#endif
@@ -4,7 +4,6 @@
 #include "../EventEngine/Event.hpp"
 #include "../EventEngine/EventListener.hpp"
 #include "../../Game/GameEngine.hpp"
-#include "../../Graphics/GraphicsEngine.hpp"
 #include "../../Sound/SoundEngine.hpp"
 #include <string>
 
@@ -15,7 +14,6 @@ class CharacterDiedListener : public EventListener
 {
 	public:
 		CharacterDiedListener(GameEngine* _gameEngine);
-		CharacterDiedListener(GraphicsEngine* _graphicsEngine);
 		CharacterDiedListener(SoundEngine* _soundEngine);
 
 		/**
@@ -27,7 +25,6 @@ class CharacterDiedListener : public EventListener
 
 	private:
 		GameEngine* m_gameEngine;
-		GraphicsEngine* m_graphicsEngine;
 		SoundEngine* m_soundEngine;
 };
 
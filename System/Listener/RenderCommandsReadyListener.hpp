@@ -0,0 +1,28 @@
+#ifndef RENDER_COMMANDS_READY_LISTENER_H
+#define RENDER_COMMANDS_READY_LISTENER_H
+
+#include "../EventEngine/Event.hpp"
+#include "../EventEngine/EventListener.hpp"
+#include "../../Graphics/GraphicsEngine.hpp"
+#include <string>
+
+/**
+* @author Kevin Guillaumond <kevin.guillaumond@gmail.com>
+*/
+class RenderCommandsReadyListener : public EventListener
+{
+	public:
+		RenderCommandsReadyListener(GraphicsEngine* _graphicsEngine);
+
+		/**
+		* Called when a render_commands_ready event is dispatched
+		* @param string eventType Type of received event
+		* @param Event* event
+		*/
+		void onEvent(const std::string &_eventType, Event* _event);
+
+	private:
+		GraphicsEngine* m_graphicsEngine;
+};
+
+#endif // RENDER_COMMANDS_READY_LISTENER_H
@@ -0,0 +1,28 @@
+#ifndef TILE_MAP_LOADED_LISTENER_H
+#define TILE_MAP_LOADED_LISTENER_H
+
+#include "../EventEngine/Event.hpp"
+#include "../EventEngine/EventListener.hpp"
+#include "../../Graphics/GraphicsEngine.hpp"
+#include <string>
+
+/**
+* @author Kevin Guillaumond <kevin.guillaumond@gmail.com>
+*/
+class TileMapLoadedListener : public EventListener
+{
+	public:
+		TileMapLoadedListener(GraphicsEngine* _graphicsEngine);
+
+		/**
+		* Called when a tile_map_loaded event is dispatched
+		* @param string eventType Type of received event
+		* @param Event* event
+		*/
+		void onEvent(const std::string &_eventType, Event* _event);
+
+	private:
+		GraphicsEngine* m_graphicsEngine;
+};
+
+#endif // TILE_MAP_LOADED_LISTENER_H
@@ -0,0 +1,34 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+
+/*
+*	Read-only view of a whole file mapped in memory: its content is read in place, pages are loaded by the system when they're touched
+*/
+class MappedFile
+{
+	public:
+		MappedFile();
+		~MappedFile();
+
+		bool Open(const std::string& _fileName);
+		void Close();
+
+		const char* GetData() const { return m_data; };
+		std::size_t GetSize() const { return m_size; };
+
+	private:
+		MappedFile(const MappedFile&);
+		MappedFile& operator=(const MappedFile&);
+
+		const char* m_data;
+		std::size_t m_size;
+#ifdef _WIN32
+		void* m_file;		// HANDLE
+		void* m_mapping;	// HANDLE
+#endif
+};
+
+#endif
@@ -0,0 +1,25 @@
+#include "RenderCommandBuffer.hpp"
+#include "AllocationTripwire.hpp"
+
+RenderCommandBuffer::RenderCommandBuffer() : m_back(0)
+{
+
+}
+
+void RenderCommandBuffer::Swap()
+{
+	m_back = 1 - m_back;
+	m_buffers[m_back].clear(); // Keeps its capacity: no allocation once the biggest frame has been seen
+	if (m_buffers[m_back].capacity() < m_buffers[1 - m_back].capacity())
+	{
+		AllocationTripwire::ExpectedAllocations expectedAllocations;
+		m_buffers[m_back].reserve(m_buffers[1 - m_back].capacity()); // Both buffers get the capacity of the level start, the first time they swap
+	}
+}
+
+/* The frame has more commands than any before it */
+void RenderCommandBuffer::Grow(const RenderCommand& _command)
+{
+	AllocationTripwire::ExpectedAllocations expectedAllocations;
+	m_buffers[m_back].push_back(_command);
+}
@@ -0,0 +1,58 @@
+#ifndef RENDERCOMMANDBUFFER_H
+#define RENDERCOMMANDBUFFER_H
+
+#include <vector>
+
+/* Drawn in this order */
+enum RenderLayer
+{
+	BACKGROUND_LAYER,
+	FOREGROUND_LAYER,
+	PIPE_LAYER,
+	CHARACTER_LAYER
+};
+
+enum RenderCommandFlags
+{
+	REVERSE_SPRITE = 1,	// Reverse sprite display (left/right)
+	REMOVE_SPRITE = 2	// The object is not displayed anymore
+};
+
+/*
+*	What g tells gfx about an object that changed during the frame. Plain data, no strings: copied as is in the buffer
+*/
+struct RenderCommand
+{
+	unsigned int handle;	// Id of the DisplayableObject
+	unsigned int spriteId;	// See SpriteRegistry
+	unsigned char state;	// State of the object, to pick the animation
+	unsigned char layer;	// RenderLayer
+	unsigned char flags;	// RenderCommandFlags
+	float left;				// Absolute coordinates
+	float top;
+	float width;
+	float height;
+};
+
+/*
+*	Render commands of a frame. g fills the back buffer while gfx reads the front one, they are swapped at the end of g's frame
+*/
+class RenderCommandBuffer
+{
+	public:
+		RenderCommandBuffer();
+
+		void Push(const RenderCommand& _command) { if (m_buffers[m_back].size() < m_buffers[m_back].capacity()) m_buffers[m_back].push_back(_command); else Grow(_command); };
+		void Reserve(unsigned int _nbCommands) { m_buffers[m_back].reserve(m_buffers[m_back].size() + _nbCommands); }; // Before pushing a whole level
+		void Swap();
+
+		const std::vector<RenderCommand>& GetFrontBuffer() const { return m_buffers[1 - m_back]; };
+
+	private:
+		void Grow(const RenderCommand& _command);
+
+		std::vector<RenderCommand> m_buffers[2];
+		int m_back;
+};
+
+#endif
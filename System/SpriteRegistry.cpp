@@ -0,0 +1,35 @@
+#include "SpriteRegistry.hpp"
+
+unsigned int SpriteRegistry::GetId(const std::string& _name)
+{
+	std::map<std::string, unsigned int>::iterator it = Ids().find(_name);
+	if (it != Ids().end())
+		return it->second;
+
+	unsigned int id = Names().size();
+	Names().push_back(_name);
+	Ids()[_name] = id;
+	return id;
+}
+
+const std::string& SpriteRegistry::GetName(unsigned int _id)
+{
+	return Names()[_id];
+}
+
+unsigned int SpriteRegistry::GetNbSprites()
+{
+	return Names().size();
+}
+
+std::map<std::string, unsigned int>& SpriteRegistry::Ids()
+{
+	static std::map<std::string, unsigned int> ids;
+	return ids;
+}
+
+std::vector<std::string>& SpriteRegistry::Names()
+{
+	static std::vector<std::string> names;
+	return names;
+}
@@ -0,0 +1,24 @@
+#ifndef SPRITEREGISTRY_H
+#define SPRITEREGISTRY_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+/*
+*	Gives an id to each sprite name (e.g. "mario", "item_question_box") when objects are created, so g and gfx can talk about sprites without strings
+*/
+class SpriteRegistry
+{
+	public:
+		static unsigned int GetId(const std::string& _name);
+		static const std::string& GetName(unsigned int _id);
+		static unsigned int GetNbSprites();
+
+	private:
+		// Function statics rather than static members: static variables don't get initialized in the other projects (see Util::GetAssetsPath)
+		static std::map<std::string, unsigned int>& Ids();
+		static std::vector<std::string>& Names();
+};
+
+#endif
@@ -0,0 +1,329 @@
+#include "TileMap.hpp"
+#include "HitboxTable.hpp"
+#include "SpriteRegistry.hpp"
+
+TileMap::TileMap() : m_nbColumns(0), m_nbRows(0), m_nbChunkRows(0), m_nbTiles(0)
+{
+
+}
+
+unsigned short TileMap::GetTypeIndex(const std::string& _spriteName)
+{
+	unsigned int spriteId = SpriteRegistry::GetId(_spriteName);
+	for (unsigned short i = 0; i < m_types.size(); i++)
+	{
+		if (m_types[i].spriteId == spriteId)
+			return i;
+	}
+
+	TileType type;
+	type.spriteId = spriteId;
+	type.size = HitboxTable::GetSize(spriteId, NORMAL);
+	type.objectClass = LEVEL_BLOCK;
+	m_types.push_back(type);
+	return (unsigned short)(m_types.size() - 1);
+}
+
+void TileMap::AddTile(unsigned short _typeIndex, sf::Vector2f _position)
+{
+	assert(_position.x >= 0 && _position.y >= 0 && _position.y / TileSize < 0x10000);
+	AddedTile tile;
+	tile.column = (unsigned int)_position.x / TileSize;
+	tile.row = (unsigned short)((unsigned int)_position.y / TileSize);
+	tile.cell = (unsigned short)(_typeIndex + 1);
+	m_addedTiles.push_back(tile);
+}
+
+/*	Each chunk is filled in a buffer of 64x64 cells, then encoded: the whole grid never exists uncompressed
+	Only the columns of chunks that received tiles are encoded again */
+void TileMap::FinishLoading()
+{
+	std::stable_sort(m_addedTiles.begin(), m_addedTiles.end());
+
+	if (m_chunks.empty())
+	{
+		unsigned int nbRows = 0;
+		for (unsigned int i = 0; i < m_addedTiles.size(); i++)
+			nbRows = std::max(nbRows, (unsigned int)m_addedTiles[i].row + 1);
+		SetSize(m_addedTiles.empty() ? 0 : m_addedTiles.back().column + 1, nbRows);
+	}
+
+	std::vector<unsigned short> cells(m_nbChunkRows * ChunkSize * ChunkSize); // One column of chunks
+	unsigned int next = 0;
+	while (next < m_addedTiles.size())
+	{
+		unsigned int chunkColumn = m_addedTiles[next].column / ChunkSize;
+		assert(m_addedTiles[next].column < m_nbColumns);
+		ClearChunkColumn(chunkColumn);
+
+		std::fill(cells.begin(), cells.end(), (unsigned short)EmptyCell);
+		for (; next < m_addedTiles.size() && m_addedTiles[next].column / ChunkSize == chunkColumn; next++)
+		{
+			unsigned int column = m_addedTiles[next].column % ChunkSize;
+			unsigned int row = m_addedTiles[next].row;
+			assert(row < m_nbRows);
+			unsigned short& cell = cells[(row / ChunkSize) * ChunkSize * ChunkSize + (row % ChunkSize) * ChunkSize + column];
+			if (cell == EmptyCell)
+				m_nbTilesInChunkColumn[chunkColumn]++;
+			cell = m_addedTiles[next].cell; // Two tiles in the same cell: the last one read stays
+		}
+		m_nbTiles += m_nbTilesInChunkColumn[chunkColumn];
+		EncodeChunkColumn(chunkColumn, cells);
+	}
+
+	std::vector<AddedTile>().swap(m_addedTiles);
+}
+
+void TileMap::LoadGrid(const unsigned short* _grid, unsigned int _nbColumns, unsigned int _nbRows, const std::vector<unsigned short>& _typeIndexes)
+{
+	SetSize(_nbColumns, _nbRows);
+
+	std::vector<unsigned short> cells(m_nbChunkRows * ChunkSize * ChunkSize); // One column of chunks
+	for (unsigned int chunkColumn = 0; chunkColumn < m_chunkData.size(); chunkColumn++)
+	{
+		m_nbTilesInChunkColumn[chunkColumn] = ReadGridChunkColumn(chunkColumn, _grid, _typeIndexes, cells);
+		m_nbTiles += m_nbTilesInChunkColumn[chunkColumn];
+		EncodeChunkColumn(chunkColumn, cells);
+	}
+}
+
+/* Each column of chunks is compared with the grid, without being decoded: an edit of the level only costs the columns it touched */
+unsigned int TileMap::UpdateGrid(const unsigned short* _grid, const std::vector<unsigned short>& _typeIndexes)
+{
+	std::vector<unsigned short> cells(m_nbChunkRows * ChunkSize * ChunkSize);
+	unsigned int nbChangedColumns = 0;
+	for (unsigned int chunkColumn = 0; chunkColumn < m_chunkData.size(); chunkColumn++)
+	{
+		unsigned int nbTiles = ReadGridChunkColumn(chunkColumn, _grid, _typeIndexes, cells);
+		bool changed = nbTiles != m_nbTilesInChunkColumn[chunkColumn];
+		for (unsigned int chunkRow = 0; chunkRow < m_nbChunkRows && !changed; chunkRow++)
+			changed = !HasCells(m_chunks[chunkColumn * m_nbChunkRows + chunkRow], m_chunkData[chunkColumn], &cells[chunkRow * ChunkSize * ChunkSize]);
+		if (!changed)
+			continue;
+
+		ClearChunkColumn(chunkColumn);
+		m_nbTilesInChunkColumn[chunkColumn] = nbTiles;
+		m_nbTiles += nbTiles;
+		EncodeChunkColumn(chunkColumn, cells);
+		nbChangedColumns++;
+	}
+	return nbChangedColumns;
+}
+
+unsigned int TileMap::ReadGridChunkColumn(unsigned int _chunkColumn, const unsigned short* _grid, const std::vector<unsigned short>& _typeIndexes, std::vector<unsigned short>& _cells) const
+{
+	std::fill(_cells.begin(), _cells.end(), (unsigned short)EmptyCell);
+	unsigned int nbTiles = 0;
+	unsigned int lastColumn = std::min(m_nbColumns, (_chunkColumn + 1) * ChunkSize);
+	for (unsigned int row = 0; row < m_nbRows; row++)
+	{
+		const unsigned short* gridRow = _grid + row * m_nbColumns;
+		for (unsigned int column = _chunkColumn * ChunkSize; column < lastColumn; column++)
+		{
+			if (gridRow[column] == NoTile)
+				continue;
+			assert(gridRow[column] < _typeIndexes.size());
+			_cells[(row / ChunkSize) * ChunkSize * ChunkSize + (row % ChunkSize) * ChunkSize + column % ChunkSize] = (unsigned short)(_typeIndexes[gridRow[column]] + 1);
+			nbTiles++;
+		}
+	}
+	return nbTiles;
+}
+
+void TileMap::EncodeChunkColumn(unsigned int _chunkColumn, const std::vector<unsigned short>& _cells)
+{
+	std::vector<unsigned int>& data = m_chunkData[_chunkColumn];
+	for (unsigned int chunkRow = 0; chunkRow < m_nbChunkRows; chunkRow++)
+		EncodeChunk(&_cells[chunkRow * ChunkSize * ChunkSize], m_chunks[_chunkColumn * m_nbChunkRows + chunkRow], data);
+	std::vector<unsigned int>(data).swap(data); // No spare capacity
+}
+
+void TileMap::SetSize(unsigned int _nbColumns, unsigned int _nbRows)
+{
+	m_nbColumns = _nbColumns;
+	m_nbRows = _nbRows;
+	m_nbChunkRows = (m_nbRows + ChunkSize - 1) / ChunkSize;
+	unsigned int nbChunkColumns = (m_nbColumns + ChunkSize - 1) / ChunkSize;
+
+	Chunk empty;
+	empty.encoding = UNIFORM_CHUNK;
+	empty.bitsPerIndex = 0;
+	empty.value = EmptyCell;
+	empty.offset = 0;
+	m_chunks.assign(nbChunkColumns * m_nbChunkRows, empty);
+	m_chunkData.assign(nbChunkColumns, std::vector<unsigned int>());
+	m_nbTilesInChunkColumn.assign(nbChunkColumns, 0);
+	m_nbTiles = 0;
+}
+
+void TileMap::ClearChunkColumn(unsigned int _chunkColumn)
+{
+	for (unsigned int chunkRow = 0; chunkRow < m_nbChunkRows; chunkRow++)
+	{
+		Chunk& chunk = m_chunks[_chunkColumn * m_nbChunkRows + chunkRow];
+		chunk.encoding = UNIFORM_CHUNK;
+		chunk.value = EmptyCell;
+	}
+	std::vector<unsigned int>().swap(m_chunkData[_chunkColumn]);
+	m_nbTiles -= m_nbTilesInChunkColumn[_chunkColumn];
+	m_nbTilesInChunkColumn[_chunkColumn] = 0;
+}
+
+/* Picks whichever of the palette and the runs takes the fewest words */
+void TileMap::EncodeChunk(const unsigned short* _cells, Chunk& _chunk, std::vector<unsigned int>& _data)
+{
+	const unsigned int nbCells = ChunkSize * ChunkSize;
+
+	std::vector<unsigned short> palette;
+	unsigned int nbRuns = 0;
+	for (unsigned int i = 0; i < nbCells; i++)
+	{
+		if (i == 0 || _cells[i] != _cells[i - 1])
+			nbRuns++;
+		if (std::find(palette.begin(), palette.end(), _cells[i]) == palette.end())
+			palette.push_back(_cells[i]);
+	}
+
+	_chunk.offset = _data.size();
+	_chunk.bitsPerIndex = 0;
+
+	if (palette.size() == 1)
+	{
+		_chunk.encoding = UNIFORM_CHUNK;
+		_chunk.value = palette[0];
+		return;
+	}
+
+	unsigned char bitsPerIndex = 1;
+	while ((1u << bitsPerIndex) < palette.size())
+		bitsPerIndex *= 2;
+	unsigned int indexesPerWord = 32 / bitsPerIndex;
+	unsigned int paletteWords = palette.size() + (nbCells + indexesPerWord - 1) / indexesPerWord;
+
+	if (nbRuns <= paletteWords)
+	{
+		_chunk.encoding = RUNS_CHUNK;
+		_chunk.value = (unsigned short)nbRuns;
+		for (unsigned int i = 0; i < nbCells; i++)
+		{
+			if (i == 0 || _cells[i] != _cells[i - 1])
+				_data.push_back((i << 16) | _cells[i]);
+		}
+		return;
+	}
+
+	_chunk.encoding = PALETTE_CHUNK;
+	_chunk.bitsPerIndex = bitsPerIndex;
+	_chunk.value = (unsigned short)palette.size();
+	_data.insert(_data.end(), palette.begin(), palette.end());
+	unsigned int firstIndexWord = _data.size();
+	_data.resize(_data.size() + (nbCells + indexesPerWord - 1) / indexesPerWord, 0);
+	for (unsigned int i = 0; i < nbCells; i++)
+	{
+		unsigned int index = std::find(palette.begin(), palette.end(), _cells[i]) - palette.begin();
+		_data[firstIndexWord + i / indexesPerWord] |= index << ((i % indexesPerWord) * bitsPerIndex);
+	}
+}
+
+unsigned short TileMap::GetCell(const Chunk& _chunk, const std::vector<unsigned int>& _data, unsigned int _index) const
+{
+	switch (_chunk.encoding)
+	{
+		case PALETTE_CHUNK:
+		{
+			unsigned int indexesPerWord = 32 / _chunk.bitsPerIndex;
+			unsigned int word = _data[_chunk.offset + _chunk.value + _index / indexesPerWord];
+			unsigned int mask = (1u << _chunk.bitsPerIndex) - 1;
+			return (unsigned short)_data[_chunk.offset + ((word >> ((_index % indexesPerWord) * _chunk.bitsPerIndex)) & mask)];
+		}
+		case RUNS_CHUNK:
+		{
+			// Last run that starts at or before the cell
+			const unsigned int* first = &_data[_chunk.offset];
+			const unsigned int* run = std::upper_bound(first, first + _chunk.value, (_index << 16) | 0xFFFF) - 1;
+			return (unsigned short)(*run & 0xFFFF);
+		}
+		case UNIFORM_CHUNK:
+		default:
+			return _chunk.value;
+	}
+}
+
+/* Runs are walked instead of looked up cell by cell: a chunk is compared in one pass whatever its encoding */
+bool TileMap::HasCells(const Chunk& _chunk, const std::vector<unsigned int>& _data, const unsigned short* _cells) const
+{
+	const unsigned int nbCells = ChunkSize * ChunkSize;
+	switch (_chunk.encoding)
+	{
+		case RUNS_CHUNK:
+		{
+			const unsigned int* runs = &_data[_chunk.offset];
+			for (unsigned int run = 0; run < _chunk.value; run++)
+			{
+				unsigned int end = run + 1 < _chunk.value ? runs[run + 1] >> 16 : nbCells;
+				unsigned short value = (unsigned short)(runs[run] & 0xFFFF);
+				for (unsigned int i = runs[run] >> 16; i < end; i++)
+				{
+					if (_cells[i] != value)
+						return false;
+				}
+			}
+			return true;
+		}
+		case UNIFORM_CHUNK:
+			return std::count(_cells, _cells + nbCells, _chunk.value) == nbCells;
+		case PALETTE_CHUNK:
+		default:
+		{
+			for (unsigned int i = 0; i < nbCells; i++)
+			{
+				if (GetCell(_chunk, _data, i) != _cells[i])
+					return false;
+			}
+			return true;
+		}
+	}
+}
+
+unsigned short TileMap::GetTile(unsigned int _column, unsigned int _row) const
+{
+	if (_column >= m_nbColumns || _row >= m_nbRows)
+		return NoTile;
+
+	const Chunk& chunk = m_chunks[(_column / ChunkSize) * m_nbChunkRows + _row / ChunkSize];
+	unsigned short cell = GetCell(chunk, m_chunkData[_column / ChunkSize], (_row % ChunkSize) * ChunkSize + _column % ChunkSize);
+	return cell == EmptyCell ? NoTile : (unsigned short)(cell - 1);
+}
+
+void TileMap::Clear()
+{
+	std::vector<Chunk>().swap(m_chunks);
+	std::vector<std::vector<unsigned int> >().swap(m_chunkData);
+	std::vector<unsigned int>().swap(m_nbTilesInChunkColumn);
+	std::vector<AddedTile>().swap(m_addedTiles);
+	m_types.clear();
+	m_nbColumns = 0;
+	m_nbRows = 0;
+	m_nbChunkRows = 0;
+	m_nbTiles = 0;
+}
+
+std::size_t TileMap::GetMemoryUsage() const
+{
+	std::size_t size = m_chunks.capacity() * sizeof(Chunk) + m_types.capacity() * sizeof(TileType);
+	size += m_chunkData.capacity() * sizeof(std::vector<unsigned int>) + m_nbTilesInChunkColumn.capacity() * sizeof(unsigned int);
+	for (unsigned int i = 0; i < m_chunkData.size(); i++)
+		size += m_chunkData[i].capacity() * sizeof(unsigned int);
+	return size;
+}
+
+unsigned int TileMap::GetNbChunks(unsigned char _encoding) const
+{
+	unsigned int nbChunks = 0;
+	for (unsigned int i = 0; i < m_chunks.size(); i++)
+	{
+		if (m_chunks[i].encoding == _encoding)
+			nbChunks++;
+	}
+	return nbChunks;
+}
@@ -0,0 +1,137 @@
+#ifndef TILEMAP_H
+#define TILEMAP_H
+
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "Util.hpp"
+
+/* What the tiles of one type share: they only differ by their position */
+struct TileType
+{
+	unsigned int spriteId;	// See SpriteRegistry
+	sf::Vector2f size;		// Hitbox, see HitboxTable
+	ObjectClass objectClass;
+};
+
+/*
+*	Static tiles of the level (the floor): no object per tile, only a type index per cell of a grid of 16 pixels
+*	The grid is cut in chunks of 64x64 cells, each one stored the cheapest way (see Chunk): the memory follows what there is in the level, not its size
+*	Collisions, drawing and saving all go through VisitTiles / GetTile. Filled by LevelImporter, owned by g and read by gfx
+*/
+class TileMap
+{
+	public:
+		static const unsigned int TileSize = 16;
+		static const unsigned int ChunkSize = 64; // In cells, on each side
+		static const unsigned short NoTile = 0xFFFF;
+
+		TileMap();
+
+		unsigned short GetTypeIndex(const std::string& _spriteName); // The type is created the first time the sprite is met
+		const TileType& GetType(unsigned short _typeIndex) const { return m_types[_typeIndex]; };
+		unsigned short GetNbTypes() const { return (unsigned short)m_types.size(); };
+
+		void AddTile(unsigned short _typeIndex, sf::Vector2f _position); // Absolute position in pixels, on the grid
+		void FinishLoading(); // Compresses the tiles added into chunks, to be called once all of them are added. Their columns of chunks are replaced
+		void Clear();
+
+		/* A level streamed by sections (see LevelStreamer) knows its size before its tiles, and loads them one column of chunks at a time */
+		void SetSize(unsigned int _nbColumns, unsigned int _nbRows);
+		void ClearChunkColumn(unsigned int _chunkColumn);
+
+		/* A compiled level has the whole grid, row by row: each cell is NoTile or an index in _typeIndexes. Replaces the tiles */
+		void LoadGrid(const unsigned short* _grid, unsigned int _nbColumns, unsigned int _nbRows, const std::vector<unsigned short>& _typeIndexes);
+		unsigned int UpdateGrid(const unsigned short* _grid, const std::vector<unsigned short>& _typeIndexes); // Same, for a grid of the same size: only the columns of chunks that changed are encoded again. Returns their number
+
+		unsigned int GetNbColumns() const { return m_nbColumns; };
+		unsigned int GetNbRows() const { return m_nbRows; };
+		unsigned short GetTile(unsigned int _column, unsigned int _row) const; // Type index, or NoTile
+
+		/* Calls _visitor(sf::Vector2f position, unsigned short typeIndex) for each tile whose cell is in _area (absolute coordinates), column by column */
+		template <typename Visitor>
+		void VisitTiles(const sf::FloatRect& _area, Visitor _visitor) const
+		{
+			if (m_nbTiles == 0)
+				return;
+
+			int firstColumn = std::max(0, (int)(_area.left / TileSize));
+			int lastColumn = std::min((int)m_nbColumns - 1, (int)((_area.left + _area.width) / TileSize));
+			int firstRow = std::max(0, (int)(_area.top / TileSize));
+			int lastRow = std::min((int)m_nbRows - 1, (int)((_area.top + _area.height) / TileSize));
+
+			for (int chunkColumn = firstColumn / (int)ChunkSize; chunkColumn <= lastColumn / (int)ChunkSize; chunkColumn++)
+			{
+				for (int chunkRow = firstRow / (int)ChunkSize; chunkRow <= lastRow / (int)ChunkSize; chunkRow++)
+				{
+					const Chunk& chunk = m_chunks[chunkColumn * m_nbChunkRows + chunkRow];
+					const std::vector<unsigned int>& data = m_chunkData[chunkColumn];
+					if (chunk.encoding == UNIFORM_CHUNK && chunk.value == EmptyCell)
+						continue;
+
+					int columnEnd = std::min(lastColumn, (chunkColumn + 1) * (int)ChunkSize - 1);
+					int rowEnd = std::min(lastRow, (chunkRow + 1) * (int)ChunkSize - 1);
+					for (int column = std::max(firstColumn, chunkColumn * (int)ChunkSize); column <= columnEnd; column++)
+					{
+						for (int row = std::max(firstRow, chunkRow * (int)ChunkSize); row <= rowEnd; row++)
+						{
+							unsigned short cell = GetCell(chunk, data, (row % ChunkSize) * ChunkSize + column % ChunkSize);
+							if (cell != EmptyCell)
+								_visitor(sf::Vector2f((float)(column * TileSize), (float)(row * TileSize)), (unsigned short)(cell - 1));
+						}
+					}
+				}
+			}
+		};
+
+		unsigned int GetNbTiles() const { return m_nbTiles; };
+		std::size_t GetMemoryUsage() const; // In bytes, what the chunks and the types take
+		unsigned int GetNbChunks(unsigned char _encoding) const;
+
+		enum ChunkEncoding
+		{
+			UNIFORM_CHUNK,	// Every cell has the same value (empty chunks): nothing else stored
+			PALETTE_CHUNK,	// The values of the chunk, then an index in them per cell, on as few bits as possible
+			RUNS_CHUNK		// Row by row, one entry each time the value changes: start (16 bits) | value (16 bits)
+		};
+
+	private:
+		/* A cell is the type index + 1, 0 for no tile. The cells of a chunk are stored row by row: a line of floor is a single run */
+		struct Chunk
+		{
+			unsigned char encoding;
+			unsigned char bitsPerIndex;	// PALETTE_CHUNK: 1, 2, 4, 8 or 16, so that no index is split between two words
+			unsigned short value;		// UNIFORM_CHUNK: the cell of the whole chunk. PALETTE_CHUNK: size of the palette. RUNS_CHUNK: number of runs
+			unsigned int offset;		// Of the data of the chunk in the data of its column of chunks
+		};
+
+		static const unsigned short EmptyCell = 0;
+
+		std::vector<TileType> m_types;
+
+		unsigned int m_nbColumns;
+		unsigned int m_nbRows;
+		unsigned int m_nbChunkRows;
+		unsigned int m_nbTiles;
+		std::vector<Chunk> m_chunks; // Column of chunks by column of chunks
+		std::vector<std::vector<unsigned int> > m_chunkData; // Per column of chunks, palettes and indexes, runs: everything that isn't uniform
+		std::vector<unsigned int> m_nbTilesInChunkColumn;
+
+		struct AddedTile
+		{
+			unsigned int column;
+			unsigned short row;
+			unsigned short cell;
+
+			bool operator<(const AddedTile& _other) const { return column < _other.column || (column == _other.column && row < _other.row); };
+		};
+		std::vector<AddedTile> m_addedTiles; // Only while loading
+
+		unsigned short GetCell(const Chunk& _chunk, const std::vector<unsigned int>& _data, unsigned int _index) const;
+		bool HasCells(const Chunk& _chunk, const std::vector<unsigned int>& _data, const unsigned short* _cells) const; // The chunk holds exactly these cells
+		void EncodeChunk(const unsigned short* _cells, Chunk& _chunk, std::vector<unsigned int>& _data);
+		void EncodeChunkColumn(unsigned int _chunkColumn, const std::vector<unsigned short>& _cells); // Cells of the whole column of chunks, chunk by chunk
+		unsigned int ReadGridChunkColumn(unsigned int _chunkColumn, const unsigned short* _grid, const std::vector<unsigned short>& _typeIndexes, std::vector<unsigned short>& _cells) const; // Returns the number of tiles
+};
+
+#endif
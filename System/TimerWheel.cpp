@@ -0,0 +1,136 @@
+#include <cassert>
+#include "TimerWheel.hpp"
+
+Timer::Timer() : m_wheel(NULL), m_slot(NULL), m_previous(NULL), m_next(NULL), m_expiry(0)
+{
+}
+
+Timer::~Timer()
+{
+	Cancel();
+}
+
+void Timer::Cancel()
+{
+	if (m_wheel != NULL)
+		m_wheel->Unlink(*this);
+}
+
+TimerWheel::TimerWheel() : m_time(0), m_pendingTime(0), m_nbTimers(0)
+{
+	for (unsigned int level = 0; level < NbLevels; level++)
+	{
+		for (unsigned int slot = 0; slot < NbSlots; slot++)
+			m_slots[level][slot] = NULL;
+	}
+}
+
+TimerWheel::~TimerWheel()
+{
+	Clear();
+}
+
+void TimerWheel::Schedule(Timer& _timer, unsigned int _milliseconds)
+{
+	_timer.Cancel();
+	_timer.m_wheel = this;
+	_timer.m_expiry = m_time + (_milliseconds > 0 ? _milliseconds : 1);
+	m_nbTimers++;
+	Insert(_timer);
+}
+
+void TimerWheel::Advance(float _dt)
+{
+	m_pendingTime += _dt * 1000;
+	unsigned int nbTicks = (unsigned int)m_pendingTime;
+	m_pendingTime -= nbTicks;
+
+	for (unsigned int i = 0; i < nbTicks; i++)
+	{
+		if (m_nbTimers == 0)
+		{
+			m_time += nbTicks - i; // Nothing to cascade or to expire
+			break;
+		}
+		Tick();
+	}
+}
+
+void TimerWheel::Clear()
+{
+	for (unsigned int level = 0; level < NbLevels; level++)
+	{
+		for (unsigned int slot = 0; slot < NbSlots; slot++)
+		{
+			while (m_slots[level][slot] != NULL)
+				Unlink(*m_slots[level][slot]);
+		}
+	}
+}
+
+/* The level is the first one whose turn goes as far as the expiry: a level further for each 64 times the distance */
+void TimerWheel::Insert(Timer& _timer)
+{
+	assert(_timer.m_expiry >= m_time);
+	unsigned long long expiry = _timer.m_expiry;
+	unsigned long long distance = expiry - m_time;
+	unsigned int level = 0;
+	while (level < NbLevels - 1 && distance >= (1ull << (SlotBits * (level + 1))))
+		level++;
+	if (distance >= (1ull << (SlotBits * NbLevels)))
+		expiry = m_time + (1ull << (SlotBits * NbLevels)) - 1; // Inserted again each time its slot is spread, until it's close enough
+
+	Timer **slot = &m_slots[level][(expiry >> (SlotBits * level)) & (NbSlots - 1)];
+	_timer.m_slot = slot;
+	_timer.m_previous = NULL;
+	_timer.m_next = *slot;
+	if (*slot != NULL)
+		(*slot)->m_previous = &_timer;
+	*slot = &_timer;
+}
+
+void TimerWheel::Unlink(Timer& _timer)
+{
+	if (_timer.m_previous != NULL)
+		_timer.m_previous->m_next = _timer.m_next;
+	else
+		*_timer.m_slot = _timer.m_next;
+	if (_timer.m_next != NULL)
+		_timer.m_next->m_previous = _timer.m_previous;
+
+	_timer.m_wheel = NULL;
+	_timer.m_slot = NULL;
+	_timer.m_previous = NULL;
+	_timer.m_next = NULL;
+	m_nbTimers--;
+}
+
+/* Each time a level finishes a turn, the next slot of the level above is spread on it. Then every timer of the slot of the tick expires */
+void TimerWheel::Tick()
+{
+	m_time++;
+	for (unsigned int level = 0; level < NbLevels - 1 && ((m_time >> (SlotBits * level)) & (NbSlots - 1)) == 0; level++)
+		Cascade(level + 1, (unsigned int)((m_time >> (SlotBits * (level + 1))) & (NbSlots - 1)));
+
+	// A timer scheduled by OnExpired is at least one tick later: never in this slot
+	Timer **slot = &m_slots[0][m_time & (NbSlots - 1)];
+	while (*slot != NULL)
+	{
+		Timer *timer = *slot;
+		assert(timer->m_expiry == m_time);
+		Unlink(*timer);
+		timer->OnExpired();
+	}
+}
+
+void TimerWheel::Cascade(unsigned int _level, unsigned int _slot)
+{
+	Timer *timer = m_slots[_level][_slot];
+	m_slots[_level][_slot] = NULL;
+	while (timer != NULL)
+	{
+		Timer *next = timer->m_next;
+		Insert(*timer);
+		timer = next;
+	}
+}
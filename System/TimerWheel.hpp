@@ -0,0 +1,77 @@
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <cstddef>
+
+class TimerWheel;
+
+/*
+*	Something to be done at a time of the simulation (see TimerWheel): owned by what it's for, usually as a member
+*	It's taken out of its wheel when it expires, when it's cancelled and when it's destroyed
+*/
+class Timer
+{
+	public:
+		Timer();
+		virtual ~Timer();
+
+		bool IsScheduled() const { return m_wheel != NULL; };
+		void Cancel(); // Nothing if it isn't scheduled
+
+	protected:
+		virtual void OnExpired() = 0; // Called by TimerWheel::Advance. The timer can be scheduled again from it
+
+	private:
+		friend class TimerWheel;
+
+		TimerWheel *m_wheel;
+		Timer **m_slot; // Head of the list it's in
+		Timer *m_previous;
+		Timer *m_next;
+		unsigned long long m_expiry; // In ticks of the wheel
+
+		Timer(const Timer&);
+		Timer& operator=(const Timer&);
+};
+
+/*
+*	Timers of the game, on the time of the simulation: what GameEngine::Frame simulated, not the wall clock. A frame that isn't simulated doesn't make them expire
+*	Hierarchical timing wheel: 4 levels of 64 slots, a tick of 1 ms. A slot of a level is a list of timers, a slot of the next level covers a whole turn of this one,
+*	and is spread on this one when the turn reaches it. Scheduling and cancelling are a link in a list, a tick only looks at one slot: only the timers that are due are touched
+*	Timers further than the wheel goes (about 4 hours) wait in its last slot. Main thread only
+*/
+class TimerWheel
+{
+	public:
+		TimerWheel();
+		~TimerWheel();
+
+		void Schedule(Timer& _timer, unsigned int _milliseconds); // Rescheduled if it already is. Expires at the first tick after that time, at least one tick later
+		void Advance(float _dt); // In seconds: the timers that are due expire, in the order of their time
+		void Clear(); // Every timer is cancelled
+
+		unsigned long long GetTime() const { return m_time; }; // In ms, since the wheel was created
+		unsigned int GetNbTimers() const { return m_nbTimers; };
+
+	private:
+		static const unsigned int NbLevels = 4;
+		static const unsigned int SlotBits = 6;
+		static const unsigned int NbSlots = 1 << SlotBits;
+
+		friend class Timer;
+
+		Timer *m_slots[NbLevels][NbSlots];
+		unsigned long long m_time; // Ticks done
+		float m_pendingTime; // Less than a tick, in ms: added to the next Advance
+		unsigned int m_nbTimers;
+
+		void Insert(Timer& _timer);
+		void Unlink(Timer& _timer);
+		void Tick();
+		void Cascade(unsigned int _level, unsigned int _slot); // The timers of the slot go to the levels below
+
+		TimerWheel(const TimerWheel&);
+		TimerWheel& operator=(const TimerWheel&);
+};
+
+#endif
@@ -1,3 +1,5 @@
+#include <fstream>
+#include <iostream>
 #include "Util.hpp"
 #include "DisplayableObject.hpp"
 
@@ -72,6 +74,90 @@ CollisionDirection Util::OppositeCollisionDirection(CollisionDirection _dir)
 	}
 }
 
+const std::vector<std::string>& Util::GetSpriteSheetNames()
+{
+	static std::vector<std::string> names;
+	if (names.empty())
+	{
+		names.push_back("background");
+		names.push_back("floor");
+		names.push_back("mario");
+		names.push_back("goomba");
+		names.push_back("item");
+	}
+	return names;
+}
+
+std::vector<SpriteRect> Util::ReadRectFile(const std::string& _sheetName)
+{
+	/* Each line looks like "state 00 00 00 00 " with the numbers being left top right bottom */
+	std::vector<SpriteRect> rects;
+	std::string buffer;
+	std::vector<std::string> splittedBuffer;
+	std::string tmpStateName;
+
+	std::ifstream rectFile;
+	rectFile.open(Util::GetAssetsPath() + "sprites/" + _sheetName + ".rect");
+
+	while (getline(rectFile, buffer))
+	{
+		if (buffer == "")
+			continue;
+
+		splittedBuffer = Util::Split(buffer, ' ');
+
+		if (splittedBuffer.size() != 5)
+		{
+			std::cerr << "Error: wrong number of items for state " << tmpStateName << " in file " << _sheetName << ".rect" << std::endl;
+			continue;
+		}
+
+		try
+		{
+			SpriteRect spriteRect;
+			tmpStateName = splittedBuffer[0];
+			spriteRect.name = _sheetName + "_" + tmpStateName;
+			spriteRect.rect.left = std::stoi(splittedBuffer[1]);
+			spriteRect.rect.top = std::stoi(splittedBuffer[2]);
+			spriteRect.rect.width = std::stoi(splittedBuffer[3]) - spriteRect.rect.left;
+			spriteRect.rect.height = std::stoi(splittedBuffer[4]) - spriteRect.rect.top;
+			rects.push_back(spriteRect);
+		}
+		catch (const std::invalid_argument& err)
+		{
+			std::cerr << "Error trying to parse state " << tmpStateName << " in file " << _sheetName << ".rect: " << err.what() << std::endl;
+		}
+	}
+
+	rectFile.close();
+	return rects;
+}
+
+/* Name of the sprite of an entity in a state, ie the name of the sprite in the RECT file (without the frame number if it's animated) */
+std::string Util::GetFullStateName(const std::string& _name, State _state)
+{
+	switch (_state)
+	{
+		case STATIC:
+			return _name + "_static";
+		case RUN:
+		case WALK:
+			return _name + "_walk";
+		case JUMP:
+			return _name + "_jump";
+		case FALL:
+			return _name + "_fall";
+		case EMPTY:
+			return _name + "_empty";
+		case UNKNOWN:
+		case NORMAL:
+			return _name;
+		default:
+			assert(false);
+			return "";
+	}
+}
+
 bool CompareInfoForDisplay::operator()(InfoForDisplay const& _a, InfoForDisplay const& _b)
 {
 	return (_a.id < _b.id);
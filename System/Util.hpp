@@ -81,6 +81,13 @@ enum SoundType
 	KICK_SND
 };
 
+/* Part of a sprite sheet, read from its RECT file. The name is the name of the sheet and the state, e.g. "mario_walk1" */
+struct SpriteRect
+{
+	std::string name;
+	sf::IntRect rect;
+};
+
 struct LevelInfo
 {
 	std::string name;
@@ -90,20 +97,52 @@ struct LevelInfo
 
 namespace Sprite
 {
-	/* To decide whether we keep the current sprite and avoid calling GetTextureNameFromDisplayInfo */
-	typedef enum {
-		STATIC,			// Yes
-		ANIMATED,		// No
-		NEW_STATIC,		// No: is static BUT different than the previous state (used to be NEW_STATE)
-		UNKNOWN
-	} StaticOrAnimated;
+	static const int NbStates = EMPTY + 1;
 
-	struct SpriteInfo
+	/* Frames of one animation, compiled from the RECT files. A static sprite is a clip with one frame */
+	struct AnimationClip
+	{
+		std::vector<unsigned int> frames; // Indexes of the textures in SpriteHandler
+	};
+
+	/* Row of the animation table: clip to play for each state of an entity (-1 if the entity has no sprite for this state) */
+	struct EntityAnimations
 	{
-		StaticOrAnimated state;
 		std::string name;
+		int clipOfState[NbStates];
+	};
+
+	/* Which frame of which clip an object is displaying. Only integers here so picking a sprite needs no string work */
+	struct SpriteInfo
+	{
+		int entityType;		// Row in the animation table, resolved once from the name of the object
+		int clip;			// -1 until the first sprite is picked
+		unsigned int frame;
 		int framesSinceLastChange;
 	};
+
+	/* What gfx keeps of a displayed object between frames, so its sprite is only touched when something actually changed */
+	struct RenderRecord
+	{
+		SpriteInfo spriteInfo;
+		State state;
+		bool reverse;
+		sf::FloatRect coordinates; // Absolute, as sent by g
+	};
+
+	/* One layer of a background: a small texture repeated over the screen, scrolling at its own speed (0: fixed, 1: like the level) */
+	struct BackgroundLayer
+	{
+		unsigned int textureIndex;
+		sf::Vector2f parallax;
+	};
+
+	/* Animated level tiles playing the same clip share one clock, so the frame is computed once for all of them */
+	struct AnimatedTileGroup
+	{
+		SpriteInfo clock;
+		std::vector<unsigned int> ids;
+	};
 }
 
 #ifdef DEBUG_MODE
@@ -139,6 +178,10 @@ class Util
 		static std::vector<std::string> Split(std::string _str, char _sep);
 		static bool StringEndsWith(std::string _full, std::string _ending);
 		static CollisionDirection OppositeCollisionDirection(CollisionDirection _dir);
+
+		static const std::vector<std::string>& GetSpriteSheetNames();
+		static std::vector<SpriteRect> ReadRectFile(const std::string& _sheetName);
+		static std::string GetFullStateName(const std::string& _name, State _state);
 };
 
 class CompareInfoForDisplay 
@@ -0,0 +1,392 @@
+#include <algorithm>
+#include <cstring>
+#include "XmlStreamReader.hpp"
+#include "irrXML/irrTypes.h"
+#include "irrXML/fast_atof.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define XML_SSE2
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+static bool IsWhiteSpace(char _c)
+{
+	return _c == ' ' || _c == '\t' || _c == '\n' || _c == '\r';
+}
+
+#ifdef XML_SSE2
+static unsigned int FirstBit(unsigned int _mask)
+{
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward(&index, _mask);
+	return index;
+#else
+	return __builtin_ctz(_mask);
+#endif
+}
+#endif
+
+/* First _a, _b or _c in [_begin, _end), _end if there's none. 16 characters are compared at once, the last ones one by one */
+static char* FindFirstOf(char* _begin, char* _end, char _a, char _b, char _c)
+{
+	char* p = _begin;
+#ifdef XML_SSE2
+	const __m128i a = _mm_set1_epi8(_a);
+	const __m128i b = _mm_set1_epi8(_b);
+	const __m128i c = _mm_set1_epi8(_c);
+	for (; _end - p >= 16; p += 16)
+	{
+		__m128i block = _mm_loadu_si128((const __m128i*)p);
+		__m128i found = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, a), _mm_cmpeq_epi8(block, b)), _mm_cmpeq_epi8(block, c));
+		unsigned int mask = (unsigned int)_mm_movemask_epi8(found);
+		if (mask != 0)
+			return p + FirstBit(mask);
+	}
+#endif
+	for (; p < _end; p++)
+	{
+		if (*p == _a || *p == _b || *p == _c)
+			return p;
+	}
+	return _end;
+}
+
+static char* FindString(char* _begin, char* _end, const char* _string)
+{
+	std::size_t length = strlen(_string);
+	for (char* p = FindFirstOf(_begin, _end, _string[0], _string[0], _string[0]); p != _end; p = FindFirstOf(p + 1, _end, _string[0], _string[0], _string[0]))
+	{
+		if ((std::size_t)(_end - p) < length)
+			return _end;
+		if (memcmp(p, _string, length) == 0)
+			return p;
+	}
+	return _end;
+}
+
+/* In place: the text can only get shorter */
+static XmlStringView ReplaceEntities(char* _begin, char* _end)
+{
+	static const char* const entities[] = { "&lt;", "&gt;", "&amp;", "&quot;", "&apos;" };
+	static const char characters[] = { '<', '>', '&', '"', '\'' };
+
+	XmlStringView view;
+	view.data = _begin;
+	char* ampersand = (char*)memchr(_begin, '&', _end - _begin);
+	if (ampersand == NULL)
+	{
+		view.size = _end - _begin;
+		return view;
+	}
+
+	char* out = ampersand;
+	for (char* in = ampersand; in < _end;)
+	{
+		unsigned int entity = 0;
+		while (*in == '&' && entity < 5 && ((std::size_t)(_end - in) < strlen(entities[entity]) || memcmp(in, entities[entity], strlen(entities[entity])) != 0))
+			entity++;
+
+		if (*in == '&' && entity < 5)
+		{
+			*out++ = characters[entity];
+			in += strlen(entities[entity]);
+		}
+		else
+			*out++ = *in++;
+	}
+	view.size = out - _begin;
+	return view;
+}
+
+bool XmlStringView::Equals(const char* _string) const
+{
+	return data != NULL && strlen(_string) == size && memcmp(data, _string, size) == 0;
+}
+
+XmlStreamReader::XmlStreamReader(std::size_t _blockSize) : m_file(NULL), m_endOfFile(true), m_position(0), m_end(0), m_blockSize(_blockSize),
+	m_nodeType(XML_NONE), m_emptyElement(false)
+{
+	m_nodeName.data = NULL;
+	m_nodeName.size = 0;
+	m_nodeData = m_nodeName;
+}
+
+XmlStreamReader::~XmlStreamReader()
+{
+	Close();
+}
+
+bool XmlStreamReader::Open(const std::string& _fileName)
+{
+	Close();
+
+	m_file = fopen(_fileName.c_str(), "rb");
+	if (m_file == NULL)
+		return false;
+
+	m_endOfFile = false;
+	m_buffer.resize(m_blockSize + 1); // + the '\0' after the data
+	m_position = 0;
+	m_end = 0;
+	while (m_end < 3 && !m_endOfFile)
+		Refill();
+
+	if (m_end >= 3 && memcmp(&m_buffer[0], "\xEF\xBB\xBF", 3) == 0) // UTF-8 byte order mark
+		m_position = 3;
+	return true;
+}
+
+void XmlStreamReader::Close()
+{
+	if (m_file != NULL)
+		fclose(m_file);
+	m_file = NULL;
+	m_endOfFile = true;
+	m_position = 0;
+	m_end = 0;
+	m_nodeType = XML_NONE;
+	m_attributes.clear();
+}
+
+bool XmlStreamReader::Read()
+{
+	m_nodeType = XML_NONE;
+	m_nodeName.data = NULL;
+	m_nodeName.size = 0;
+	m_nodeData = m_nodeName;
+	m_emptyElement = false;
+	m_attributes.clear();
+
+	while (true)
+	{
+		std::size_t length = 0;
+		ParseResult result = m_position < m_end ? ParseNode(&m_buffer[m_position], &m_buffer[0] + m_end, length) : PARSE_INCOMPLETE;
+
+		if (result == PARSE_INCOMPLETE)
+		{
+			if (m_endOfFile)
+				result = PARSE_ERROR; // Or just the end of the file, if there's nothing left
+			else
+			{
+				// Nothing was changed in the buffer: the node is parsed again from its start
+				Refill();
+				continue;
+			}
+		}
+
+		if (result == PARSE_ERROR)
+		{
+			m_nodeType = XML_NONE;
+			m_attributes.clear();
+			m_position = m_end;
+			return false;
+		}
+
+		m_position += length;
+		if (result == PARSE_NODE)
+			return true;
+	}
+}
+
+void XmlStreamReader::Refill()
+{
+	std::size_t remaining = m_end - m_position;
+	if (m_position > 0)
+		memmove(&m_buffer[0], &m_buffer[m_position], remaining);
+	m_position = 0;
+	m_end = remaining;
+
+	// The buffer is full with one node: twice as big, so that a long node is read again only a few times
+	if (m_buffer.size() - 1 - m_end < m_blockSize)
+		m_buffer.resize(std::max(m_buffer.size() * 2, m_end + m_blockSize + 1));
+
+	std::size_t toRead = m_buffer.size() - 1 - m_end;
+	std::size_t nbRead = fread(&m_buffer[m_end], 1, toRead, m_file);
+	m_end += nbRead;
+	m_buffer[m_end] = '\0';
+	m_endOfFile = nbRead < toRead;
+}
+
+XmlStreamReader::ParseResult XmlStreamReader::ParseNode(char* _begin, char* _end, std::size_t& _length)
+{
+	if (*_begin != '<')
+		return ParseText(_begin, _end, _length);
+	if (_end - _begin < 2)
+		return PARSE_INCOMPLETE;
+
+	char* nodeEnd;
+	switch (_begin[1])
+	{
+		case '/':
+			nodeEnd = FindFirstOf(_begin + 2, _end, '>', '>', '>');
+			if (nodeEnd == _end)
+				return PARSE_INCOMPLETE;
+			m_nodeType = XML_ELEMENT_END;
+			m_nodeName.data = _begin + 2;
+			m_nodeName.size = 0;
+			while (_begin + 2 + m_nodeName.size < nodeEnd && !IsWhiteSpace(_begin[2 + m_nodeName.size]))
+				m_nodeName.size++;
+			_length = nodeEnd + 1 - _begin;
+			return PARSE_NODE;
+
+		case '?':
+			nodeEnd = FindString(_begin + 2, _end, "?>");
+			if (nodeEnd == _end)
+				return PARSE_INCOMPLETE;
+			_length = nodeEnd + 2 - _begin;
+			return PARSE_SKIPPED;
+
+		case '!':
+			if (_end - _begin < 9 && !m_endOfFile)
+				return PARSE_INCOMPLETE; // Not enough to know if it's a comment or a CDATA
+			if (_end - _begin >= 4 && memcmp(_begin, "<!--", 4) == 0)
+			{
+				nodeEnd = FindString(_begin + 4, _end, "-->");
+				if (nodeEnd == _end)
+					return PARSE_INCOMPLETE;
+				_length = nodeEnd + 3 - _begin;
+				return PARSE_SKIPPED;
+			}
+			if (_end - _begin >= 9 && memcmp(_begin, "<![CDATA[", 9) == 0)
+			{
+				nodeEnd = FindString(_begin + 9, _end, "]]>");
+				if (nodeEnd == _end)
+					return PARSE_INCOMPLETE;
+				m_nodeType = XML_TEXT;
+				m_nodeData.data = _begin + 9;
+				m_nodeData.size = nodeEnd - _begin - 9;
+				_length = nodeEnd + 3 - _begin;
+				return PARSE_NODE;
+			}
+			nodeEnd = FindFirstOf(_begin + 2, _end, '>', '>', '>'); // <!DOCTYPE ...>, without any internal declaration
+			if (nodeEnd == _end)
+				return PARSE_INCOMPLETE;
+			_length = nodeEnd + 1 - _begin;
+			return PARSE_SKIPPED;
+
+		default:
+			return ParseElement(_begin, _end, _length);
+	}
+}
+
+XmlStreamReader::ParseResult XmlStreamReader::ParseText(char* _begin, char* _end, std::size_t& _length)
+{
+	char* textEnd = FindFirstOf(_begin, _end, '<', '<', '<');
+	if (textEnd == _end && !m_endOfFile)
+		return PARSE_INCOMPLETE;
+	_length = textEnd - _begin;
+
+	// The indentation between two tags isn't reported
+	char* p = _begin;
+	while (p < textEnd && IsWhiteSpace(*p))
+		p++;
+	if (p == textEnd)
+		return PARSE_SKIPPED;
+
+	m_nodeType = XML_TEXT;
+	m_nodeData = ReplaceEntities(_begin, textEnd);
+	return PARSE_NODE;
+}
+
+XmlStreamReader::ParseResult XmlStreamReader::ParseElement(char* _begin, char* _end, std::size_t& _length)
+{
+	// The whole tag has to be in the buffer before anything is replaced in it: the first > out of the attribute values
+	char* tagEnd = _begin + 1;
+	while (true)
+	{
+		tagEnd = FindFirstOf(tagEnd, _end, '>', '"', '\'');
+		if (tagEnd == _end)
+			return PARSE_INCOMPLETE;
+		if (*tagEnd == '>')
+			break;
+
+		char* valueEnd = FindFirstOf(tagEnd + 1, _end, *tagEnd, *tagEnd, *tagEnd);
+		if (valueEnd == _end)
+			return PARSE_INCOMPLETE;
+		tagEnd = valueEnd + 1;
+	}
+	_length = tagEnd + 1 - _begin;
+
+	m_emptyElement = tagEnd[-1] == '/';
+	if (m_emptyElement)
+		tagEnd--;
+
+	char* nameEnd = _begin + 1;
+	while (nameEnd < tagEnd && !IsWhiteSpace(*nameEnd))
+		nameEnd++;
+	if (nameEnd == _begin + 1)
+		return PARSE_ERROR;
+
+	m_nodeType = XML_ELEMENT;
+	m_nodeName.data = _begin + 1;
+	m_nodeName.size = nameEnd - _begin - 1;
+	return ParseAttributes(nameEnd, tagEnd) ? PARSE_NODE : PARSE_ERROR;
+}
+
+/* name="value" or name='value', until _end */
+bool XmlStreamReader::ParseAttributes(char* _begin, char* _end)
+{
+	char* p = _begin;
+	while (true)
+	{
+		while (p < _end && IsWhiteSpace(*p))
+			p++;
+		if (p == _end)
+			return true;
+
+		char* equal = FindFirstOf(p, _end, '=', '=', '=');
+		if (equal == _end)
+			return false;
+		char* nameEnd = equal;
+		while (nameEnd > p && IsWhiteSpace(nameEnd[-1]))
+			nameEnd--;
+
+		char* quote = equal + 1;
+		while (quote < _end && IsWhiteSpace(*quote))
+			quote++;
+		if (quote == _end || (*quote != '"' && *quote != '\''))
+			return false;
+		char* valueEnd = FindFirstOf(quote + 1, _end, *quote, *quote, *quote);
+		if (valueEnd == _end)
+			return false;
+
+		Attribute attribute;
+		attribute.name.data = p;
+		attribute.name.size = nameEnd - p;
+		attribute.value = ReplaceEntities(quote + 1, valueEnd);
+		m_attributes.push_back(attribute);
+		p = valueEnd + 1;
+	}
+}
+
+XmlStringView XmlStreamReader::GetAttribute(const char* _name) const
+{
+	for (unsigned int i = 0; i < m_attributes.size(); i++)
+	{
+		if (m_attributes[i].name.Equals(_name))
+			return m_attributes[i].value;
+	}
+
+	XmlStringView missing;
+	missing.data = NULL;
+	missing.size = 0;
+	return missing;
+}
+
+float XmlStreamReader::GetAttributeAsFloat(const char* _name) const
+{
+	XmlStringView value = GetAttribute(_name);
+	if (value.IsNull())
+		return -1;
+
+	// The value isn't null-terminated in the buffer
+	char number[64];
+	std::size_t size = std::min(value.size, sizeof(number) - 1);
+	memcpy(number, value.data, size);
+	number[size] = '\0';
+	return irr::core::fast_atof(number);
+}
@@ -0,0 +1,96 @@
+#ifndef XMLSTREAMREADER_H
+#define XMLSTREAMREADER_H
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+enum XmlNodeType
+{
+	XML_NONE,
+	XML_ELEMENT,		// <name ...> or <name .../>
+	XML_ELEMENT_END,	// </name>
+	XML_TEXT			// Text between tags (not only white spaces) or CDATA
+};
+
+/* Characters in the buffer of the reader, not null-terminated. data is NULL for something that isn't there (a missing attribute) */
+struct XmlStringView
+{
+	const char* data;
+	std::size_t size;
+
+	bool IsNull() const { return data == NULL; };
+	bool Equals(const char* _string) const;
+	std::string ToString() const { return data != NULL ? std::string(data, size) : std::string(); };
+};
+
+/*
+*	Reader of the level files, node by node, as irrXML's but without loading the whole file: it's read by blocks in a buffer,
+*	which is only made bigger for a node that doesn't fit in it (a long <tile_layer>).
+*	The delimiters (<, >, ", =) are found 16 bytes at a time with SSE2 when it's there.
+*	Names, values and text are views into the buffer: they're only valid until the next call to Read.
+*	UTF-8 (or ASCII) only. The 5 predefined entities are replaced, comments, <?...?> and <!DOCTYPE> are skipped
+*/
+class XmlStreamReader
+{
+	public:
+		XmlStreamReader(std::size_t _blockSize = 64 * 1024);
+		~XmlStreamReader();
+
+		bool Open(const std::string& _fileName);
+		void Close();
+
+		bool Read(); // Next node. False at the end of the file, or if the rest of the file isn't well-formed
+
+		XmlNodeType GetNodeType() const { return m_nodeType; };
+		XmlStringView GetNodeName() const { return m_nodeName; };	// Of an element
+		XmlStringView GetNodeData() const { return m_nodeData; };	// Of a text
+		bool IsEmptyElement() const { return m_emptyElement; };		// <name .../>: there won't be an XML_ELEMENT_END for it
+
+		unsigned int GetNbAttributes() const { return m_attributes.size(); };
+		XmlStringView GetAttributeName(unsigned int _index) const { return m_attributes[_index].name; };
+		XmlStringView GetAttributeValue(unsigned int _index) const { return m_attributes[_index].value; };
+		XmlStringView GetAttribute(const char* _name) const;
+		float GetAttributeAsFloat(const char* _name) const;	// -1 if the attribute isn't there, like irrXML
+		int GetAttributeAsInt(const char* _name) const { return (int)GetAttributeAsFloat(_name); };
+
+	private:
+		XmlStreamReader(const XmlStreamReader&);
+		XmlStreamReader& operator=(const XmlStreamReader&);
+
+		struct Attribute
+		{
+			XmlStringView name;
+			XmlStringView value;
+		};
+
+		enum ParseResult
+		{
+			PARSE_NODE,			// A node to report
+			PARSE_SKIPPED,		// Comment, declaration or white spaces
+			PARSE_INCOMPLETE,	// The node goes on after the data in the buffer
+			PARSE_ERROR
+		};
+
+		std::FILE* m_file;
+		bool m_endOfFile;
+		std::vector<char> m_buffer;
+		std::size_t m_position;		// Start of the next node in m_buffer
+		std::size_t m_end;			// End of the data read in m_buffer
+		std::size_t m_blockSize;
+
+		XmlNodeType m_nodeType;
+		XmlStringView m_nodeName;
+		XmlStringView m_nodeData;
+		bool m_emptyElement;
+		std::vector<Attribute> m_attributes;
+
+		void Refill(); // What isn't parsed yet is moved to the start of the buffer, the rest of the buffer is filled from the file
+		ParseResult ParseNode(char* _begin, char* _end, std::size_t& _length); // _length: of the node in the buffer, if it's complete
+		ParseResult ParseText(char* _begin, char* _end, std::size_t& _length);
+		ParseResult ParseElement(char* _begin, char* _end, std::size_t& _length);
+		bool ParseAttributes(char* _begin, char* _end);
+};
+
+#endif